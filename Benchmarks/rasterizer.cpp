@@ -0,0 +1,279 @@
+//
+//  rasterizer.cpp
+//  ComputerGraphics
+//
+//  Created by agent on 10/17/26.
+//  Copyright © 2026 agent. All rights reserved.
+//
+//  times each stage of rendering a scene separately:
+//    parse      reading the text file with operator>> and with SceneParser
+//    transform  ConvexPolygon::set (copies the points and transforms them) and PolygonBatch::transform
+//    scan       ConvexPolygon::scanConvert of every polygon with one thread and no hierarchical z-buffer
+//    points     ConvexPolygonRasterizer::addPoints z-testing random points
+//    pipeline   ConvexPolygonRasterizer::addPolygons (binning, hierarchical z-buffer, and threads)
+//  for the scene files given and a random scene (see SceneGenerator) of the size given
+//  built as the rasterizerBenchmark target of CMakeLists.txt
+//  usage: rasterizer [--iterations N] [--polygons N] [--vertices MIN MAX] [--radius R] [--overdraw X]
+//                    [--points N] [--threads N] [--seed S] [scene files...]
+//  (defaults to 20 iterations, DataFiles/in1.txt through in3.txt, and 10000 polygons with 3 to 8 vertices and overdraw 4;
+//   --polygons 0 skips the random scene, and --radius sets the size of the polygons instead of --overdraw)
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "ConvexPolygonRasterizer.hpp"
+#include "PolygonBatch.hpp"
+#include "SceneGenerator.hpp"
+#include "SceneParser.hpp"
+
+using namespace std;
+
+/// width and height of the buffers
+static const int Width = 960, Height = 540;
+
+/// mean and minimum time of the iterations of a stage
+struct Timing {
+    double mean, min;
+};
+
+/// settings from the command line
+struct Settings {
+    int iterations = 20;
+    int numPoints = 1000000;
+    int numThreads = 0;
+    SceneGenerator::Options scene;
+    vector<string> filenames;
+};
+
+/// call setup (not timed) and then stage iterations times
+/// @return mean and minimum milliseconds per call of stage
+template <typename Setup, typename Stage>
+static Timing timeStage(int iterations, Setup setup, Stage stage) {
+    Timing timing = {0.0, 1e30};
+    for (int i=0; i<iterations; ++i) {
+        setup();
+        auto start = chrono::steady_clock::now();
+        stage();
+        auto end = chrono::steady_clock::now();
+        double milliseconds = chrono::duration<double, milli>(end - start).count();
+        timing.mean += milliseconds;
+        timing.min = min(timing.min, milliseconds);
+    }
+    timing.mean /= iterations;
+    return timing;
+}
+
+/// call stage iterations times
+/// @return mean and minimum milliseconds per call
+template <typename Stage>
+static Timing timeStage(int iterations, Stage stage) {
+    return timeStage(iterations, []() {}, stage);
+}
+
+/// print the timing of one stage
+static void report(const char *stage, const Timing &timing) {
+    printf("  %-22s %10.3f ms mean %10.3f ms min\n", stage, timing.mean, timing.min);
+}
+
+/// time every stage on the polygons in a text scene file
+/// @param filename scene file
+/// @param settings iterations and number of points and threads
+/// @return false if the file could not be read
+static bool benchmark(const string &filename, const Settings &settings) {
+    int iterations = settings.iterations;
+
+    SceneParser parser(filename);
+    if (!parser.isOpen()) {
+        cerr << "error opening: " << filename << endl;
+        return false;
+    }
+    vector<ConvexPolygon> polygons;
+    ConvexPolygon polygon;
+    size_t numPoints = 0;
+    while (parser.readPolygon(polygon)) {
+        polygons.push_back(polygon);
+        numPoints += polygon.points().size();
+    }
+    if (parser.failed()) {
+        cerr << parser.error() << endl;
+    }
+    printf("%s: %zu polygons, %zu points\n", filename.c_str(), polygons.size(), numPoints);
+
+    // the parsers are checked against the number of points read above so the work cannot be skipped
+    size_t pointsRead = 0;
+    report("parse operator>>", timeStage(iterations, [&]() {
+        ifstream is(filename);
+        ConvexPolygon p;
+        for (size_t i=0; i<polygons.size() && is >> p; ++i) {
+            pointsRead += p.points().size();
+        }
+    }));
+    report("parse SceneParser", timeStage(iterations, [&]() {
+        SceneParser fileParser(filename);
+        ConvexPolygon p;
+        while (fileParser.readPolygon(p)) {
+            pointsRead += p.points().size();
+        }
+    }));
+    if (pointsRead != 2 * iterations * numPoints) {
+        printf("  (parsers read %zu points instead of %zu)\n", pointsRead, 2 * iterations * numPoints);
+    }
+
+    // the first set copies the points into copies' storage so the timed ones only transform
+    vector<ConvexPolygon> copies(polygons.size());
+    auto setAll = [&]() {
+        for (size_t i=0; i<polygons.size(); ++i) {
+            const ConvexPolygon &p = polygons[i];
+            copies[i].set(p.points(), p.color(), p.scaleX(), p.scaleY(), p.translateX(), p.translateY(), p.theta());
+        }
+    };
+    setAll();
+    report("transform set", timeStage(iterations, setAll));
+
+    PolygonBatch batch;
+    batch.reserve(polygons.size(), numPoints);
+    for (const ConvexPolygon &p: polygons) {
+        batch.add(p);
+    }
+    report("transform batch", timeStage(iterations, [&]() {
+        for (size_t i=0; i<polygons.size(); ++i) {
+            const ConvexPolygon &p = polygons[i];
+            batch.setTransform(i, p.scaleX(), p.scaleY(), p.translateX(), p.translateY(), p.theta());
+        }
+        batch.transform();
+    }));
+
+    ConvexPolygonRasterizer rasterizer(Width, Height);
+    rasterizer.setUseHierarchicalZ(false);
+    report("scanConvert", timeStage(iterations, [&]() { rasterizer.clear(); }, [&]() {
+        for (const ConvexPolygon &p: polygons) {
+            const vector<vec4> &pts = p.transformedPoints();
+            ConvexPolygon::scanConvert(&rasterizer, pts.data(), int(pts.size()), p.color(), 0, 0, Width - 1, Height - 1, ConvexPolygonRasterizer::NoPolygon);
+        }
+    }));
+
+    // random points covering the buffers at the depths of the polygons, tested against the drawn polygons
+    mt19937 engine(settings.scene.seed);
+    uniform_real_distribution<float> randomX(0.0f, float(Width)), randomY(0.0f, float(Height));
+    uniform_real_distribution<float> randomZ(settings.scene.nearZ, settings.scene.farZ);
+    vector<Point3D> pts(settings.numPoints);
+    for (Point3D &p: pts) {
+        p.x = randomX(engine);
+        p.y = randomY(engine);
+        p.z = randomZ(engine);
+    }
+    size_t numVisible = 0;
+    report("addPoints", timeStage(iterations, [&]() {
+        rasterizer.clear();
+        rasterizer.addPolygons(polygons);
+    }, [&]() {
+        numVisible += rasterizer.addPoints(pts, Color(1, 1, 1));
+    }));
+    printf("  %-22s (%zu points, %zu in front of the polygons)\n", "", pts.size(), numVisible / iterations);
+
+    rasterizer.setUseHierarchicalZ(true);
+    rasterizer.setNumThreads(1);
+    report("addPolygons 1 thread", timeStage(iterations, [&]() {
+        rasterizer.clear();
+        rasterizer.addPolygons(polygons);
+    }));
+    rasterizer.setNumThreads(settings.numThreads);
+    char label[64];
+    snprintf(label, sizeof(label), "addPolygons %d threads", rasterizer.numThreads());
+    report(label, timeStage(iterations, [&]() {
+        rasterizer.clear();
+        rasterizer.addPolygons(polygons);
+    }));
+    return true;
+}
+
+int main(int argc, char **argv) {
+    Settings settings;
+    settings.scene.numPolygons = 10000;
+    settings.scene.overdraw = 4.0f;
+    settings.scene.width = Width;
+    settings.scene.height = Height;
+
+    for (int i=1; i<argc; ++i) {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--iterations" && hasValue) {
+            settings.iterations = max(1, atoi(argv[++i]));
+        }
+        else if (arg == "--polygons" && hasValue) {
+            settings.scene.numPolygons = strtoul(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--vertices" && i + 2 < argc) {
+            settings.scene.minVertices = atoi(argv[++i]);
+            settings.scene.maxVertices = atoi(argv[++i]);
+        }
+        else if (arg == "--radius" && hasValue) {
+            settings.scene.radius = float(atof(argv[++i]));
+            settings.scene.overdraw = 0.0f;
+        }
+        else if (arg == "--overdraw" && hasValue) {
+            settings.scene.overdraw = float(atof(argv[++i]));
+        }
+        else if (arg == "--points" && hasValue) {
+            settings.numPoints = atoi(argv[++i]);
+        }
+        else if (arg == "--threads" && hasValue) {
+            settings.numThreads = atoi(argv[++i]);
+        }
+        else if (arg == "--seed" && hasValue) {
+            settings.scene.seed = uint32_t(strtoul(argv[++i], nullptr, 10));
+        }
+        else if (arg.compare(0, 2, "--") == 0) {
+            cerr << "unknown or incomplete option: " << arg << endl;
+            return EXIT_FAILURE;
+        }
+        else {
+            settings.filenames.push_back(arg);
+        }
+    }
+    if (settings.filenames.empty()) {
+        settings.filenames.push_back("DataFiles/in1.txt");
+        settings.filenames.push_back("DataFiles/in2.txt");
+        settings.filenames.push_back("DataFiles/in3.txt");
+    }
+
+    int status = EXIT_SUCCESS;
+    for (const string &filename: settings.filenames) {
+        if (!benchmark(filename, settings)) {
+            status = EXIT_FAILURE;
+        }
+    }
+
+    // the random scene is written as a text file so the parsers are timed on it too
+    if (settings.scene.numPolygons > 0) {
+        SceneGenerator generator(settings.scene);
+        string filename = "rasterizerBenchmark.txt";
+        {
+            ofstream os(filename);
+            os.precision(9);
+            ConvexPolygon polygon;
+            for (size_t i=0; i<settings.scene.numPolygons; ++i) {
+                generator.next(polygon);
+                os << polygon;
+            }
+            if (!os) {
+                cerr << "error writing: " << filename << endl;
+                return EXIT_FAILURE;
+            }
+        }
+        printf("random scene: %d to %d vertices, radius %.1f, seed %u\n", generator.options().minVertices, generator.options().maxVertices, generator.radius(), generator.options().seed);
+        if (!benchmark(filename, settings)) {
+            status = EXIT_FAILURE;
+        }
+        remove(filename.c_str());
+    }
+    return status;
+}
@@ -0,0 +1,81 @@
+//
+//  zBufferLayout.cpp
+//  ComputerGraphics
+//
+//  Created by agent on 10/17/26.
+//  Copyright © 2026 agent. All rights reserved.
+//
+//  compares the time to rasterize scene files with a row-major and a tiled z-buffer
+//  built as the zBufferLayout target of CMakeLists.txt
+//  usage: zBufferLayout [iterations] [scene files...] (defaults to 100 and DataFiles/in1.txt DataFiles/in3.txt)
+//
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "ConvexPolygonRasterizer.hpp"
+#include "SceneParser.hpp"
+
+using namespace std;
+
+/// rasterize polygons iterations times with one thread and the given layout
+/// @return average milliseconds per iteration
+static double timeLayout(const vector<ConvexPolygon> &polygons, Array2D::Layout layout, int iterations, vector<Color> &image) {
+    double totalMilliseconds = 0.0;
+    for (int i=0; i<iterations; ++i) {
+        ConvexPolygonRasterizer rasterizer(960, 540, layout);
+        rasterizer.setNumThreads(1);
+        auto start = chrono::steady_clock::now();
+        rasterizer.addPolygons(polygons);
+        auto end = chrono::steady_clock::now();
+        totalMilliseconds += chrono::duration<double, milli>(end - start).count();
+        if (i == 0) {
+            image.assign(rasterizer.colorBuffer(), rasterizer.colorBuffer() + rasterizer.width() * rasterizer.height());
+        }
+    }
+    return totalMilliseconds / iterations;
+}
+
+int main(int argc, char **argv) {
+    int iterations = argc > 1 ? atoi(argv[1]) : 100;
+    vector<string> filenames;
+    for (int i=2; i<argc; ++i) {
+        filenames.push_back(argv[i]);
+    }
+    if (filenames.empty()) {
+        filenames.push_back("DataFiles/in1.txt");
+        filenames.push_back("DataFiles/in3.txt");
+    }
+
+    for (const string &filename: filenames) {
+        SceneParser parser(filename);
+        if (!parser.isOpen()) {
+            cerr << "error opening: " << filename << endl;
+            return EXIT_FAILURE;
+        }
+        vector<ConvexPolygon> polygons;
+        ConvexPolygon polygon;
+        while (parser.readPolygon(polygon)) {
+            polygons.push_back(polygon);
+        }
+        if (parser.failed()) {
+            cerr << parser.error() << endl;
+        }
+
+        vector<Color> rowMajorImage, tiledImage;
+        double rowMajor = timeLayout(polygons, Array2D::RowMajor, iterations, rowMajorImage);
+        double tiled = timeLayout(polygons, Array2D::Tiled, iterations, tiledImage);
+        bool same = rowMajorImage.size() == tiledImage.size();
+        for (size_t i=0; same && i<rowMajorImage.size(); ++i) {
+            same = rowMajorImage[i].r == tiledImage[i].r && rowMajorImage[i].g == tiledImage[i].g && rowMajorImage[i].b == tiledImage[i].b;
+        }
+
+        cout << filename << ": " << polygons.size() << " polygons" << endl;
+        cout << "  row-major: " << rowMajor << " ms" << endl;
+        cout << "  tiled:     " << tiled << " ms" << (same ? "" : " (images differ!)") << endl;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,120 @@
+//
+//  Array2D.hpp
+//  Array2D
+//
+//  Created by David M. Reed on 2/19/20.
+//  Copyright © 2020 David Reed. All rights reserved.
+//
+
+#ifndef Array2D_hpp
+#define Array2D_hpp
+
+#include <memory>
+
+// MARK: version 3 smart pointers as one dimensional array
+
+// class for representing a 2D array of data
+// stored row by row (RowMajor) or as BlockSize x BlockSize blocks that are each stored row by row (Tiled)
+// so elements that are close vertically are also close in memory
+class Array2D {
+public:
+    /// how the elements are ordered in memory
+    enum Layout { RowMajor, Tiled };
+
+    /// width and height of the blocks of the Tiled layout
+    static const int BlockSize = 8;
+
+    /// initialize two-dimensional array with specified size
+    /// @param numRows number of rows in 2D array
+    /// @param numColumns number of columns in 2D array
+    /// @param layout how the elements are ordered in memory
+    Array2D(int numRows = 0, int numColumns = 0, Layout layout = RowMajor);
+
+    /// helper method for constructor or allows you to reconstruct with different size
+    /// @param numRows number of rows in 2D array
+    /// @param numColumns number of columns in 2D array
+    /// @param layout how the elements are ordered in memory
+    void init(int numRows, int numColumns, Layout layout = RowMajor);
+
+    /// returns the address of the first element in the row (RowMajor layout only)
+    /// thus we could write:
+    /// float *row = array2D[rowNumber];
+    /// and since pointers can be treated as arrays we can now write
+    /// float x = row[columnNumber];
+    /// or in one step array2D[rowNumber][columnNumber]
+    /// note if columnNumber is >= _numColumns you are accessing elements in later rows
+    float* operator[](const int row) const;
+
+    /// returns the element at row, column for either layout
+    /// for the Tiled layout the elements from column to the end of its block are next to each other in memory
+    float& operator()(const int row, const int column) const;
+
+    /// how the elements are ordered in memory
+    Layout layout() const { return _layout; }
+
+    /// number of rows
+    int numRows() const { return _numRows; }
+
+    /// number of columns
+    int numColumns() const { return _numColumns; }
+
+    /// number of elements allocated (the Tiled layout rounds rows and columns up to a multiple of BlockSize)
+    size_t size() const { return _size; }
+
+    /// set every element to value
+    void fill(float value);
+
+private:
+    Array2D(const Array2D &);
+    std::unique_ptr<float[]> _data;
+    int _numRows;
+    int _numColumns;
+    Layout _layout;
+    int _numBlockColumns;
+    size_t _size;
+};
+
+inline Array2D::Array2D(int numRows, int numColumns, Layout layout) {
+    init(numRows, numColumns, layout);
+}
+
+inline void Array2D::init(int numRows, int numColumns, Layout layout) {
+    _numRows = numRows;
+    _numColumns = numColumns;
+    _layout = layout;
+    _data = nullptr;
+    _numBlockColumns = (numColumns + BlockSize - 1) / BlockSize;
+    _size = 0;
+
+    if (_numRows > 0 && _numColumns > 0) {
+        if (layout == Tiled) {
+            int numBlockRows = (numRows + BlockSize - 1) / BlockSize;
+            _size = size_t(numBlockRows) * _numBlockColumns * BlockSize * BlockSize;
+        }
+        else {
+            _size = size_t(numRows) * numColumns;
+        }
+        _data = std::make_unique<float[]>(_size);
+    }
+}
+
+inline float* Array2D::operator[](const int row) const {
+    return &_data[row * _numColumns];
+}
+
+inline float& Array2D::operator()(const int row, const int column) const {
+    if (_layout == RowMajor) {
+        return _data[row * _numColumns + column];
+    }
+    // find the block, then the element within the block
+    int block = (row / BlockSize) * _numBlockColumns + column / BlockSize;
+    return _data[block * BlockSize * BlockSize + (row % BlockSize) * BlockSize + column % BlockSize];
+}
+
+inline void Array2D::fill(float value) {
+    for (size_t i=0; i<_size; ++i) {
+        _data[i] = value;
+    }
+}
+
+#endif /* Array2D_hpp */
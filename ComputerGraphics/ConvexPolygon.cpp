@@ -6,7 +6,9 @@
 //  Copyright © 2019 David M Reed. All rights reserved.
 //
 
-#include "ConvexPolygonRenderer.hpp"
+#include <algorithm>
+#include <cmath>
+#include "ConvexPolygonRasterizer.hpp"
 #include "ConvexPolygon.hpp"
 
 ConvexPolygon::ConvexPolygon(const std::vector<Point3D> &pts, const Color &color, const float scaleX, const float scaleY, const float translateX, const float translateY, const float theta) {
@@ -21,6 +23,18 @@ void ConvexPolygon::set(const std::vector<Point3D> &pts, const Color &color, con
     _translateX = translateX;
     _translateY = translateY;
     _theta = theta;
+    _updateTransform();
+}
+
+void ConvexPolygon::set(const Point3D *pts, size_t numPts, const Color &color, const float scaleX, const float scaleY, const float translateX, const float translateY, const float theta) {
+    _pts.assign(pts, pts + numPts);
+    _color = color;
+    _scaleX = scaleX;
+    _scaleY = scaleY;
+    _translateX = translateX;
+    _translateY = translateY;
+    _theta = theta;
+    _updateTransform();
 }
 
 Point3D ConvexPolygon::centerPoint() const {
@@ -38,7 +52,7 @@ Point3D ConvexPolygon::centerPoint() const {
     return center;
 }
 
-void ConvexPolygon::render(ConvexPolygonRenderer *renderer) {
+void ConvexPolygon::_updateTransform() {
 
     Point3D center = centerPoint();
     // note last matrix is applied to point first
@@ -48,109 +62,183 @@ void ConvexPolygon::render(ConvexPolygonRenderer *renderer) {
     // apply translation
     mat4 transform = Translate(_translateX, _translateY, 0) * Translate(center.x, center.y, 0) * RotateZ(_theta) * Scale(_scaleX, _scaleY, 1.0) * Translate(-center.x, -center.y, 0.0);
 
+    // only the x and y rows depend on the polygon's parameters (z and w are unchanged)
+    // so keep them as a 2x3 affine transform
+    for (int row=0; row<2; ++row) {
+        _affine[row][0] = transform[row][0];
+        _affine[row][1] = transform[row][1];
+        _affine[row][2] = transform[row][3];
+    }
+
     // transform each point and put in vector of <vec4>
-    Point3D p;
-    std::vector<vec4> transformedPts;
     auto numPoints = _pts.size();
-    for (auto i=0; i<numPoints; ++i) {
-        vec4 v = vec4(_pts[i].x, _pts[i].y, _pts[i].z, 1.0);
-        v = transform * v;
-        transformedPts.push_back(v);
+    _transformedPts.resize(numPoints);
+    for (size_t i=0; i<numPoints; ++i) {
+        const Point3D &p = _pts[i];
+        // same sums as the full mat4 * vec4 without the terms that are always 0
+        _transformedPts[i] = vec4(_affine[0][0] * p.x + _affine[0][1] * p.y + _affine[0][2],
+                                  _affine[1][0] * p.x + _affine[1][1] * p.y + _affine[1][2],
+                                  p.z, 1.0);
+    }
+}
+
+void ConvexPolygon::render(ConvexPolygonRasterizer *rasterizer) const {
+    // the rasterizer clips it in its own memory if it is far outside the buffers
+    rasterizer->drawPolygon(_transformedPts.data(), int(_transformedPts.size()), _color);
+}
+
+// vertices up to this many pixels outside the buffers are scan converted as they are with each span clipped;
+// polygons with vertices farther away are clipped to the buffers first so the span end points stay small ints
+static const float GuardBand = 4096.0f;
+
+// PointArrays reads vec4s as arrays of floats stepping by 4
+static_assert(sizeof(vec4) == 4 * sizeof(float), "vec4 must be packed");
+
+bool ConvexPolygon::isInsideGuardBand(const PointArrays &transformedPts, int numPoints, int width, int height) {
+    for (int i=0; i<numPoints; ++i) {
+        float x = transformedPts.x(i);
+        float y = transformedPts.y(i);
+        if (!(x >= -GuardBand && x <= width + GuardBand && y >= -GuardBand && y <= height + GuardBand)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// Sutherland-Hodgman clip a convex polygon to one side of a line, interpolating all the coordinates
+/// @param pts points of the polygon
+/// @param numPoints number of points
+/// @param clipped where the clipped polygon is stored (at most maxPoints points)
+/// @param maxPoints room in clipped (a convex polygon gains at most one point)
+/// @param inside signed distance of a point from the line (>= 0 is kept)
+/// @return number of points in clipped
+template <typename Distance>
+static int clipToLine(const PointArrays &pts, int numPoints, vec4 *clipped, int maxPoints, Distance inside) {
+    int numClipped = 0;
+    for (int i=0; i<numPoints; ++i) {
+        int next = (i + 1) % numPoints;
+        vec4 p0(pts.x(i), pts.y(i), pts.z(i), 1.0);
+        vec4 p1(pts.x(next), pts.y(next), pts.z(next), 1.0);
+        float d0 = inside(p0);
+        float d1 = inside(p1);
+        if (d0 >= 0 && numClipped < maxPoints) {
+            clipped[numClipped++] = p0;
+        }
+        // add the point where the edge crosses the line
+        if ((d0 >= 0) != (d1 >= 0) && numClipped < maxPoints) {
+            float t = d0 / (d0 - d1);
+            clipped[numClipped++] = p0 + t * (p1 - p0);
+        }
     }
-    // scanline fill the polygon
-    _polygonFill(renderer, transformedPts);
+    return numClipped;
+}
+
+int ConvexPolygon::clipToBuffers(const PointArrays &transformedPts, int numPoints, int width, int height, vec4 *clipped) {
+    // clip to each side in turn going back and forth between the two halves of clipped
+    float minX = -1.0f, minY = -1.0f;
+    float maxX = float(width), maxY = float(height);
+    int maxPoints = maxClippedPoints(numPoints);
+    vec4 *scratch = clipped + maxPoints;
+    numPoints = clipToLine(transformedPts, numPoints, scratch, maxPoints, [=](const vec4 &p) { return p.x - minX; });
+    numPoints = clipToLine(scratch, numPoints, clipped, maxPoints, [=](const vec4 &p) { return maxX - p.x; });
+    numPoints = clipToLine(clipped, numPoints, scratch, maxPoints, [=](const vec4 &p) { return p.y - minY; });
+    return clipToLine(scratch, numPoints, clipped, maxPoints, [=](const vec4 &p) { return maxY - p.y; });
 }
 
-void ConvexPolygon::_polygonFill(ConvexPolygonRenderer *renderer, std::vector<vec4> transformedPts) {
+void ConvexPolygon::scanConvert(ConvexPolygonRasterizer *rasterizer, const PointArrays &transformedPts, int numPoints, const Color &color, int clipMinX, int clipMinY, int clipMaxX, int clipMaxY, uint32_t polygonID) {
 
     // find min and max y vertices of polygon
-    float floatMinY, floatMaxY;
-    floatMinY = floatMaxY = transformedPts[0].y;
-    auto numPoints = transformedPts.size();
+    int minIndex = 0, maxIndex = 0;
+    if (numPoints == 0) {
+        return;
+    }
     for (auto i=1; i<numPoints; ++i) {
-        auto y = transformedPts[i].y;
-        if (y < floatMinY) {
-            floatMinY = y;
+        auto y = transformedPts.y(i);
+        if (y < transformedPts.y(minIndex)) {
+            minIndex = i;
         }
-        else if (y > floatMaxY) {
-            floatMaxY = y;
+        else if (y > transformedPts.y(maxIndex)) {
+            maxIndex = i;
         }
     }
-    int minY = int(floatMinY + 0.5);
-    int maxY = int(floatMaxY + 0.5);
+    // only rows between the min and max y are inside the polygon
+    // and only those inside the clip rectangle are drawn
+    int minY = std::max(int(ceil(transformedPts.y(minIndex))), clipMinY);
+    int maxY = std::min(int(floor(transformedPts.y(maxIndex))), clipMaxY);
 
-    // list of points to draw
-    std::vector<Point3D> fillPts;
+    // a convex polygon has exactly two chains of edges from its min y vertex to its max y vertex
+    // so walk one going forward through the points and one going backward
+    _EdgeWalker forward(transformedPts, numPoints, minIndex, maxIndex, 1);
+    _EdgeWalker backward(transformedPts, numPoints, minIndex, maxIndex, -1);
 
-    // vector for the intersection x and z points for a given y value
-    std::vector<std::tuple<int, float>> intersections;
     for (auto y=minY; y<=maxY; ++y) {
-        // clear out the intersections from previous y value
-        intersections.clear();
-
-        // for each edge
-        auto p0 = transformedPts[numPoints - 1];
-        for (auto i=0; i<numPoints; ++i) {
-            auto p1 = transformedPts[i];
-            int x;
-            float z;
-
-            // else if one point above y and one point below y
-            if ((p0.y <= y and y <= p1.y) or (p0.y >= y and y >= p1.y)) {
-                // if horizontal line since we need to divide by y differences for parametric equation
-                if (fabs(p0.y - p1.y) < 0.001) {
-                    x = int(p0.x + 0.5);
-                    
-                    //push both the current x and z value to the intersections list
-                    intersections.push_back(std::make_tuple(x, p0.z));
-                    x = int(p1.x + 0.5);
-                    intersections.push_back(std::make_tuple(x, p1.z));
-                }
-                else {
-                    //  use parametric equation to find intersection point
-                    auto t = (y - p0.y) / (p1.y - p0.y);
-                    x = int(p0.x + t * (p1.x - p0.x) + 0.5);
-                    z = p0.z + t * (p1.z - p0.z);
-
-                    intersections.push_back(std::make_tuple(x, z));
-                }
-            }
-            // move to next pair of points
-            p0 = p1;
+        forward.moveTo(y);
+        backward.moveTo(y);
+
+        // the chains may cross over each other so find which one is on the left
+        // (floor rounds x to the nearest column the same way on both sides of 0)
+        int minX = int(floor(forward.x + 0.5f));
+        float minZ = forward.z;
+        int maxX = int(floor(backward.x + 0.5f));
+        float maxZ = backward.z;
+        if (maxX < minX) {
+            std::swap(minX, maxX);
+            std::swap(minZ, maxZ);
         }
 
-        // fill points between the intersection points
-        if (intersections.size() >= 1) {
-            // may be more than two intersection points if hits vertices
-            // so find min and max x & z for the y
-            int minX = std::get<0>(intersections[0]);
-            float minZ = std::get<1>(intersections[0]);
-            
-            int maxX = std::get<0>(intersections[0]);
-            float maxZ = std::get<1>(intersections[0]);
-
-
-            for (auto j=1; j<intersections.size(); ++j) {
-                if (std::get<0>(intersections[j]) < minX) {
-                    minX = std::get<0>(intersections[j]);
-                    minZ = std::get<1>(intersections[j]);
-                }
-                else if (std::get<0>(intersections[j]) > maxX) {
-                    maxX = std::get<0>(intersections[j]);
-                    maxZ = std::get<1>(intersections[j]);
-                }
-            }
-            // add points to fill between them
-            float z;
-            for (int x=minX; x<=maxX; ++x) {
-                //add z value using slope of z with percentage between min and max x
-                z = float((x - minX)) / float((maxX - minX)) * (maxZ - minZ) + minZ;
-                
-                fillPts.push_back(Point3D(x, y, z));
-            }
+        // depth test and fill the part of the span between them inside the clip rectangle
+        // stepping z by its slope across the span
+        float dz = maxX > minX ? (maxZ - minZ) / float(maxX - minX) : 0.0f;
+        int firstX = std::max(minX, clipMinX);
+        int lastX = std::min(maxX, clipMaxX);
+        if (firstX <= lastX) {
+            rasterizer->fillSpan(y, minX, minZ, dz, firstX, lastX, color, polygonID);
         }
     }
-    _renderID = renderer->addPoints(fillPts, _color, 1.0, mat4());
+}
+
+ConvexPolygon::_EdgeWalker::_EdgeWalker(const PointArrays &pts, int numPoints, int start, int end, int step) : _pts(pts) {
+    _numPoints = numPoints;
+    _end = end;
+    _step = step;
+    _i0 = start;
+    _i1 = start;
+    x = _x0 = pts.x(start);
+    z = _z0 = pts.z(start);
+    _y0 = pts.y(start);
+    _dxdy = _dzdy = 0.0f;
+}
+
+void ConvexPolygon::_EdgeWalker::moveTo(int y) {
+    // rows are visited in increasing order so stay on the current edge
+    // unless y has passed its end point (or it is horizontal and contributes nothing)
+    bool newEdge = false;
+    while (_i1 != _end && (_pts.y(_i1) < y || _i1 == _i0 || fabs(_pts.y(_i1) - _pts.y(_i0)) < 0.001)) {
+        _i0 = _i1;
+        _i1 = (_i1 + _step + _numPoints) % _numPoints;
+        newEdge = true;
+    }
+
+    if (newEdge) {
+        // precompute the per row deltas for this edge
+        float dy = _pts.y(_i1) - _pts.y(_i0);
+        if (fabs(dy) < 0.001) {
+            _dxdy = _dzdy = 0.0f;
+            _x0 = _pts.x(_i1);
+            _z0 = _pts.z(_i1);
+        }
+        else {
+            _dxdy = (_pts.x(_i1) - _pts.x(_i0)) / dy;
+            _dzdy = (_pts.z(_i1) - _pts.z(_i0)) / dy;
+            _x0 = _pts.x(_i0);
+            _z0 = _pts.z(_i0);
+        }
+        _y0 = _pts.y(_i0);
+    }
+    // step from the start of the edge rather than accumulating the deltas so the
+    // intersection does not depend on which row the walk started at (e.g., the top of a tile)
+    x = _x0 + (y - _y0) * _dxdy;
+    z = _z0 + (y - _y0) * _dzdy;
 }
 
 std::istream& operator>>(std::istream &is, ConvexPolygon &polygon) {
@@ -180,3 +268,18 @@ std::istream& operator>>(std::istream &is, ConvexPolygon &polygon) {
     polygon.set(pts, color, sx, sy, tx, ty, theta);
     return is;
 }
+
+std::ostream& operator<<(std::ostream &os, const ConvexPolygon &polygon) {
+    const std::vector<Point3D> &pts = polygon.points();
+    Color color = polygon.color();
+
+    os << pts.size() << "\n";
+    for (const Point3D &p: pts) {
+        os << p.x << " " << p.y << " " << p.z << "\n";
+    }
+    os << color.r << " " << color.g << " " << color.b << "\n";
+    os << polygon.scaleX() << " " << polygon.scaleY() << "\n";
+    os << polygon.translateX() << " " << polygon.translateY() << "\n";
+    os << polygon.theta() << "\n\n";
+    return os;
+}
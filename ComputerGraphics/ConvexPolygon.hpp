@@ -9,11 +9,46 @@
 #ifndef ConvexPolygon_hpp
 #define ConvexPolygon_hpp
 
+#include <cstdint>
 #include <iostream>
+#include <vector>
 
-#include "graphics.hpp"
+#include "Angel.hpp"
+#include "Point.hpp"
+#include "Color.hpp"
 
-class ConvexPolygonRenderer;
+class ConvexPolygonRasterizer;
+
+/// transformed points of a polygon as separate x, y, and z arrays (e.g., PolygonBatch)
+/// or as vec4s (e.g., ConvexPolygon::transformedPoints), which are the same arrays stepping by 4 floats
+class PointArrays {
+public:
+    /// points in vec4s
+    PointArrays(const vec4 *pts) {
+        const float *first = reinterpret_cast<const float*>(pts);
+        _x = first;
+        _y = first + 1;
+        _z = first + 2;
+        _stride = 4;
+    }
+
+    /// points in separate arrays
+    PointArrays(const float *xs, const float *ys, const float *zs) : _x(xs), _y(ys), _z(zs), _stride(1) {}
+
+    /// x coordinate of point i
+    float x(int i) const { return _x[i * _stride]; }
+
+    /// y coordinate of point i
+    float y(int i) const { return _y[i * _stride]; }
+
+    /// depth of point i
+    float z(int i) const { return _z[i * _stride]; }
+
+private:
+    const float *_x, *_y, *_z;
+    // floats from one point to the next in each array
+    int _stride;
+};
 
 class ConvexPolygon {
 
@@ -38,22 +73,122 @@ public:
     /// @param theta - rotate Z amount in degrees
     void set(const std::vector<Point3D> &pts, const Color &color, const float scaleX = 1.0, const float scaleY = 1.0, const float translateX = 0.0, const float translateY = 0.0, const float theta = 0.0);
 
+    /// set ConvexPolygon to specified value copying the points from an array (e.g., a memory mapped file)
+    /// @param pts array of coordinate points (must form a convex polygon)
+    /// @param numPts number of points in pts
+    /// @param color color for polygon
+    /// @param scaleX x-scale factor
+    /// @param scaleY y-scale factor
+    /// @param translateX x-translate amount
+    /// @param translateY y-translate amount
+    /// @param theta - rotate Z amount in degrees
+    void set(const Point3D *pts, size_t numPts, const Color &color, const float scaleX = 1.0, const float scaleY = 1.0, const float translateX = 0.0, const float translateY = 0.0, const float theta = 0.0);
+
     /// returns center point of ConvexPolygon
     Point3D centerPoint() const;
 
-    /// sets ConvexPolygon up to be drawn as a filled polygon for its coordinate and color
-    /// @param renderer the Renderer to use to draw the polygon
-    void render(ConvexPolygonRenderer *renderer);
+    /// returns color of ConvexPolygon
+    Color color() const { return _color; }
+
+    /// returns the untransformed points of ConvexPolygon
+    const std::vector<Point3D>& points() const { return _pts; }
+
+    /// returns x-scale factor
+    float scaleX() const { return _scaleX; }
+
+    /// returns y-scale factor
+    float scaleY() const { return _scaleY; }
+
+    /// returns x-translate amount
+    float translateX() const { return _translateX; }
+
+    /// returns y-translate amount
+    float translateY() const { return _translateY; }
+
+    /// returns rotate Z amount in degrees
+    float theta() const { return _theta; }
+
+    /// returns the points of ConvexPolygon after applying its scale, rotate and translate
+    /// (computed when the polygon is set rather than each time they are needed)
+    const std::vector<vec4>& transformedPoints() const { return _transformedPts; }
+
+    /// scan converts ConvexPolygon as a filled polygon for its coordinates and color
+    /// (the polygon is not stored by the rasterizer so its pixels get the polygon ID NoPolygon)
+    /// @param rasterizer the rasterizer whose z-buffer the polygon is drawn into
+    void render(ConvexPolygonRasterizer *rasterizer) const;
+
+    /// scan converts a transformed convex polygon inside the rectangle from (minX, minY) to (maxX, maxY) inclusive
+    /// (used by the rasterizer for stored polygons and for polygons whose points are stored elsewhere such as a PolygonBatch)
+    /// the points must be inside the guard band (see isInsideGuardBand); clip other polygons with clipToBuffers first
+    /// @param rasterizer the rasterizer whose z-buffer the polygon is drawn into
+    /// @param transformedPts transformed points of the polygon
+    /// @param numPoints number of points
+    /// @param color color for polygon
+    /// @param minX left column of rectangle
+    /// @param minY bottom row of rectangle
+    /// @param maxX right column of rectangle
+    /// @param maxY top row of rectangle
+    /// @param polygonID ID the rasterizer stores for each pixel drawn if it writes polygon IDs
+    static void scanConvert(ConvexPolygonRasterizer *rasterizer, const PointArrays &transformedPts, int numPoints, const Color &color, int minX, int minY, int maxX, int maxY, uint32_t polygonID);
+
+    /// true if every point is close enough to width x height buffers for scanConvert to draw the polygon as it is
+    /// (scanConvert clips each span, which only works while the span end points are small ints)
+    /// @param transformedPts transformed points of the polygon
+    /// @param numPoints number of points
+    /// @param width width of the buffers
+    /// @param height height of the buffers
+    static bool isInsideGuardBand(const PointArrays &transformedPts, int numPoints, int width, int height);
+
+    /// most points clipToBuffers can store for a polygon with numPoints points (each side of the buffers adds at most one)
+    static int maxClippedPoints(int numPoints) { return numPoints + 4; }
+
+    /// clip a transformed convex polygon to width x height buffers (plus a pixel on each side) without allocating memory
+    /// @param transformedPts transformed points of the polygon
+    /// @param numPoints number of points
+    /// @param width width of the buffers
+    /// @param height height of the buffers
+    /// @param clipped room for 2 * maxClippedPoints(numPoints) points; the clipped polygon is stored at the start
+    /// and the rest is used while clipping
+    /// @return number of points of the clipped polygon
+    static int clipToBuffers(const PointArrays &transformedPts, int numPoints, int width, int height, vec4 *clipped);
 
 private:
-    void _polygonFill(ConvexPolygonRenderer *renderer, std::vector<vec4> transformedPts);
+    /// compose the scale, rotate and translate into _affine and transform the points with it
+    void _updateTransform();
+
+    /// steps along one chain of polygon edges from the min y vertex to the max y vertex
+    /// x and z come from precomputed per row deltas of the current edge, only switching edges at vertices
+    class _EdgeWalker {
+    public:
+        /// @param pts transformed points of the polygon
+        /// @param numPoints number of points
+        /// @param start index of min y vertex
+        /// @param end index of max y vertex
+        /// @param step 1 to walk forward through pts or -1 to walk backward
+        _EdgeWalker(const PointArrays &pts, int numPoints, int start, int end, int step);
+
+        /// move to row y (rows must be visited in increasing order)
+        void moveTo(int y);
+
+        // intersection of the chain with the current row
+        float x, z;
+
+    private:
+        PointArrays _pts;
+        int _numPoints;
+        int _i0, _i1, _end, _step;
+        float _x0, _y0, _z0;
+        float _dxdy, _dzdy;
+    };
 
     std::vector<Point3D> _pts;
     Color _color;
     float _scaleX, _scaleY;
     float _translateX, _translateY;
     float _theta;
-    size_t _renderID;
+    // x' = _affine[0][0] * x + _affine[0][1] * y + _affine[0][2] (and the same for y' with row 1)
+    float _affine[2][3];
+    std::vector<vec4> _transformedPts;
 };
 
 /// input operator for ConvexPolygon
@@ -61,4 +196,10 @@ private:
 /// @param polygon poylgon to store data from stream in
 std::istream& operator>>(std::istream &is, ConvexPolygon &polygon);
 
+/// output operator for ConvexPolygon in the format operator>> reads (followed by a blank line)
+/// uses the precision of os, so set it to 9 to read back exactly the same floats
+/// @param os output stream
+/// @param polygon polygon to write
+std::ostream& operator<<(std::ostream &os, const ConvexPolygon &polygon);
+
 #endif /* ConvexPolygon_hpp */
@@ -0,0 +1,808 @@
+//
+//  ConvexPolygonRasterizer.cpp
+//  ComputerGraphics
+//
+//  Created by agent on 10/17/26.
+//  Copyright © 2026 agent. All rights reserved.
+//
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include "ConvexPolygonRasterizer.hpp"
+#include "SceneFile.hpp"
+#include "SceneParser.hpp"
+
+const uint32_t ConvexPolygonRasterizer::NoPolygon;
+
+/// the stored polygons from first on numbered from 0 for _rasterizePolygons
+class StoredPolygons {
+public:
+    StoredPolygons(const PolygonBatch &polygons, size_t first) : _polygons(polygons), _first(first) {}
+
+    size_t numPoints(size_t i) const { return _polygons.numPoints(_first + i); }
+    const Color& color(size_t i) const { return _polygons.color(_first + i); }
+    PointArrays transformedPoints(size_t i) const { return _polygons.transformedPoints(_first + i); }
+
+private:
+    const PolygonBatch &_polygons;
+    size_t _first;
+};
+
+ConvexPolygonRasterizer::ConvexPolygonRasterizer(int width, int height, Array2D::Layout zBufferLayout) {
+    _width = width;
+    _height = height;
+    _zBufferLayout = zBufferLayout;
+    _zBuffer.init(height, width, zBufferLayout);
+    _zBuffer.fill(INFINITY);
+    // nothing drawn yet so the max depth of every block is INFINITY
+    _hiZWidth = (width + HiZBlockSize - 1) / HiZBlockSize;
+    _hiZHeight = (height + HiZBlockSize - 1) / HiZBlockSize;
+    _hiZ.assign(_hiZWidth * _hiZHeight, INFINITY);
+    _hiZDirty.assign(_hiZWidth * _hiZHeight, false);
+    _blockGeneration.assign(_hiZWidth * _hiZHeight, 0);
+    _generation = 0;
+    _useHierarchicalZ = true;
+    _sortFrontToBack = false;
+    _depthFormat = Float32;
+    _depthRangeSet = true;
+    _automaticDepthRange = false;
+    _spanFillUInt16 = nullptr;
+    _spanFillUInt32 = nullptr;
+    // Color constructor defaults to black
+    _colorBuffer = std::make_unique<Color[]>(width * height);
+    _spanFill = bestSpanFillFunction();
+    _spanFillIDs = bestSpanFillIDsFunction();
+    setNumThreads(0);
+}
+
+bool ConvexPolygonRasterizer::renderFile(const std::string &filename) {
+    // binary scene files are used straight from the mapped file
+    SceneFile scene(filename);
+    if (scene.isSceneFile()) {
+        if (scene.failed()) {
+            std::cerr << scene.error() << std::endl;
+            return false;
+        }
+        size_t first = _polygons.size();
+        _polygons.reserve(first + scene.numPolygons(), _polygons.numPoints() + scene.numPoints());
+        for (size_t i=0; i<scene.numPolygons(); ++i) {
+            const SceneFilePolygon &p = scene.polygon(i);
+            _polygons.add(scene.points(i), scene.numPoints(i), Color(p.r, p.g, p.b), p.scaleX, p.scaleY, p.translateX, p.translateY, p.theta);
+        }
+        // the polygons are stored for polygons(), polygonAt and replacePolygon, but the ones whose bounding box
+        // is outside the buffers are skipped without reading their points
+        _rasterizePolygons(first, _polygons.size(), scene.boundingBoxes());
+        return true;
+    }
+
+    // otherwise it is a text scene file
+    SceneParser parser(filename);
+    if (!parser.isOpen()) {
+        return false;
+    }
+
+    // while not end of file parse polygons straight into the arrays of the stored polygons
+    // (which grow by doubling rather than allocating the points of each polygon separately)
+    size_t first = _polygons.size();
+    while (parser.readPolygon(_polygons)) {
+    }
+
+    // and rasterize them all at once (including the ones read before any malformed input)
+    _rasterizePolygons(first, _polygons.size());
+    if (parser.failed()) {
+        std::cerr << parser.error() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void ConvexPolygonRasterizer::addPolygon(const ConvexPolygon &polygon) {
+    // store it (and its bounds for replacePolygon) in case we want to use it in the future
+    size_t i = _polygons.size();
+    _polygons.add(polygon);
+    _polygons.transform();
+    _polygonBounds.push_back(_drawPolygon(_polygons.transformedPoints(i), int(_polygons.numPoints(i)), _polygons.color(i), uint32_t(i)));
+}
+
+void ConvexPolygonRasterizer::drawPolygon(const PointArrays &transformedPts, int numPoints, const Color &color, uint32_t polygonID) {
+    _drawPolygon(transformedPts, numPoints, color, polygonID);
+}
+
+ConvexPolygonRasterizer::_PixelBounds ConvexPolygonRasterizer::_drawPolygon(const PointArrays &transformedPts, int numPoints, const Color &color, uint32_t polygonID) {
+    // render it unless it is entirely behind what has already been drawn
+    _PixelBounds bounds;
+    if (!_pixelBounds(transformedPts, numPoints, bounds)) {
+        return _emptyBounds();
+    }
+    _setAutomaticDepthRange(bounds.minZ, bounds.maxZ);
+    if (!_isHidden(bounds.minX, bounds.minY, bounds.maxX, bounds.maxY, bounds.minZ)) {
+        _arena.reset();
+        PointArrays pts = _guardBandPoints(transformedPts, numPoints);
+        ConvexPolygon::scanConvert(this, pts, numPoints, color, bounds.minX, bounds.minY, bounds.maxX, bounds.maxY, polygonID);
+    }
+    return bounds;
+}
+
+void ConvexPolygonRasterizer::addPolygons(const std::vector<ConvexPolygon> &polygons) {
+    // store them in case we want to use them in the future
+    size_t first = _polygons.size();
+    size_t numPoints = _polygons.numPoints();
+    for (const ConvexPolygon &polygon: polygons) {
+        numPoints += polygon.points().size();
+    }
+    _polygons.reserve(first + polygons.size(), numPoints);
+    for (const ConvexPolygon &polygon: polygons) {
+        _polygons.add(polygon);
+    }
+    _rasterizePolygons(first, _polygons.size());
+}
+
+void ConvexPolygonRasterizer::addPolygons(const PolygonBatch &batch) {
+    // the batch polygons are not stored so there is no index in polygons() for polygonAt to return
+    _rasterizePolygons(batch, batch.size(), nullptr, NoPolygon);
+}
+
+ConvexPolygonRasterizer::PixelRectangle ConvexPolygonRasterizer::replacePolygon(size_t index, const ConvexPolygon &polygon) {
+    if (index >= _polygons.size()) {
+        throw std::out_of_range("replacePolygon: index " + std::to_string(index) + " is not the index of a stored polygon");
+    }
+    _PixelBounds oldBounds = _polygonBounds[index];
+    _polygons.set(index, polygon);
+    _polygons.transform();
+    _PixelBounds &newBounds = _polygonBounds[index];
+    if (_pixelBounds(_polygons.transformedPoints(index), int(_polygons.numPoints(index)), newBounds)) {
+        _setAutomaticDepthRange(newBounds.minZ, newBounds.maxZ);
+    }
+    else {
+        newBounds = _emptyBounds();
+    }
+
+    // the pixels that can change are the ones the polygon covered before or covers now
+    PixelRectangle dirty;
+    if (oldBounds.minX > oldBounds.maxX) {
+        dirty = { newBounds.minX, newBounds.minY, newBounds.maxX, newBounds.maxY };
+    }
+    else if (newBounds.minX > newBounds.maxX) {
+        dirty = { oldBounds.minX, oldBounds.minY, oldBounds.maxX, oldBounds.maxY };
+    }
+    else {
+        dirty.minX = std::min(oldBounds.minX, newBounds.minX);
+        dirty.minY = std::min(oldBounds.minY, newBounds.minY);
+        dirty.maxX = std::max(oldBounds.maxX, newBounds.maxX);
+        dirty.maxY = std::max(oldBounds.maxY, newBounds.maxY);
+    }
+    if (!dirty.isEmpty()) {
+        _redrawRectangle(dirty);
+    }
+    return dirty;
+}
+
+void ConvexPolygonRasterizer::_redrawRectangle(const PixelRectangle &rectangle) {
+    _clearRectangle(rectangle);
+
+    // find the stored polygons that overlap it
+    _arena.reset();
+    size_t *order = _arena.allocate<size_t>(_polygonBounds.size());
+    size_t numOverlapping = 0;
+    for (size_t i=0; i<_polygonBounds.size(); ++i) {
+        const _PixelBounds &b = _polygonBounds[i];
+        if (b.minX <= rectangle.maxX && b.maxX >= rectangle.minX && b.minY <= rectangle.maxY && b.maxY >= rectangle.minY) {
+            order[numOverlapping++] = i;
+        }
+    }
+    // in the same order _rasterizePolygons draws them
+    if (_sortFrontToBack) {
+        std::sort(order, order + numOverlapping, [&](size_t a, size_t b) {
+            const _PixelBounds &boundsA = _polygonBounds[a];
+            const _PixelBounds &boundsB = _polygonBounds[b];
+            return boundsA.minZ < boundsB.minZ || (boundsA.minZ == boundsB.minZ && a < b);
+        });
+    }
+
+    // and draw the part of each one inside the rectangle
+    for (size_t j=0; j<numOverlapping; ++j) {
+        size_t i = order[j];
+        const _PixelBounds &b = _polygonBounds[i];
+        int minX = std::max(b.minX, rectangle.minX);
+        int minY = std::max(b.minY, rectangle.minY);
+        int maxX = std::min(b.maxX, rectangle.maxX);
+        int maxY = std::min(b.maxY, rectangle.maxY);
+        if (!_isHidden(minX, minY, maxX, maxY, b.minZ)) {
+            int numPoints = int(_polygons.numPoints(i));
+            PointArrays pts = _guardBandPoints(_polygons.transformedPoints(i), numPoints);
+            ConvexPolygon::scanConvert(this, pts, numPoints, _polygons.color(i), minX, minY, maxX, maxY, uint32_t(i));
+        }
+    }
+}
+
+void ConvexPolygonRasterizer::_clearRectangle(const PixelRectangle &rectangle) {
+    int numColumns = rectangle.maxX - rectangle.minX + 1;
+    for (int y=rectangle.minY; y<=rectangle.maxY; ++y) {
+        _clearOldBlocks(y, rectangle.minX, rectangle.maxX);
+        std::fill_n(&_colorBuffer[y * _width + rectangle.minX], numColumns, Color());
+        if (_polygonIDs) {
+            std::fill_n(&_polygonIDs[y * _width + rectangle.minX], numColumns, NoPolygon);
+        }
+        switch (_depthFormat) {
+            case UInt16:
+                std::fill_n(&_depth16[y * _width + rectangle.minX], numColumns, uint16_t(_depthMapping.maxValue));
+                break;
+            case UInt24:
+            case UInt32:
+                std::fill_n(&_depth32[y * _width + rectangle.minX], numColumns, _depthMapping.maxValue);
+                break;
+            default:
+                // the columns of a row are not all next to each other in the Tiled layout
+                for (int x=rectangle.minX; x<=rectangle.maxX; ++x) {
+                    _zBuffer(y, x) = INFINITY;
+                }
+                break;
+        }
+        // the max depths of the blocks are found again the next time they are needed
+        _markHiZDirty(y, rectangle.minX, rectangle.maxX);
+    }
+}
+
+ConvexPolygonRasterizer::_PixelBounds ConvexPolygonRasterizer::_emptyBounds() {
+    _PixelBounds bounds;
+    bounds.minX = bounds.minY = 0;
+    bounds.maxX = bounds.maxY = -1;
+    bounds.minZ = bounds.maxZ = INFINITY;
+    return bounds;
+}
+
+void ConvexPolygonRasterizer::_rasterizePolygons(size_t first, size_t last, const SceneFileBoundingBox *boxes) {
+    // keep the bounds of the stored polygons for replacePolygon
+    _polygons.transform();
+    _polygonBounds.resize(last);
+    _rasterizePolygons(StoredPolygons(_polygons, first), last - first, _polygonBounds.data() + first, uint32_t(first), boxes);
+}
+
+template <typename Polygons>
+void ConvexPolygonRasterizer::_rasterizePolygons(const Polygons &polygons, size_t numPolygons, _PixelBounds *storedBounds, uint32_t firstID, const SceneFileBoundingBox *boxes) {
+    int numTilesX = (_width + TileSize - 1) / TileSize;
+    int numTilesY = (_height + TileSize - 1) / TileSize;
+
+    // all the scratch memory comes from _arena so once it has grown large enough no frame uses the heap
+    _arena.reset();
+    int numTiles = numTilesX * numTilesY;
+
+    // find the pixels each polygon can cover
+    // and clip the ones far outside the buffers once here instead of in every tile they are drawn in
+    // (the clipped polygon is the same for every tile so tiles still match drawing it all at once)
+    _PixelBounds *bounds = storedBounds != nullptr ? storedBounds : _arena.allocate<_PixelBounds>(numPolygons);
+    size_t *order = _arena.allocate<size_t>(numPolygons);
+    PointArrays *points = _arena.allocate<PointArrays>(numPolygons);
+    int *numPoints = _arena.allocate<int>(numPolygons);
+    size_t numVisible = 0;
+    for (size_t i=0; i<numPolygons; ++i) {
+        numPoints[i] = int(polygons.numPoints(i));
+        if (boxes != nullptr && !_overlapsBuffers(boxes[i].minX, boxes[i].minY, boxes[i].maxX, boxes[i].maxY)) {
+            bounds[i] = _emptyBounds();
+        }
+        else if (_pixelBounds(polygons.transformedPoints(i), numPoints[i], bounds[i])) {
+            points[i] = _guardBandPoints(polygons.transformedPoints(i), numPoints[i]);
+            order[numVisible++] = i;
+        }
+        else {
+            bounds[i] = _emptyBounds();
+        }
+    }
+    if (_automaticDepthRange && numVisible > 0) {
+        float minZ = bounds[order[0]].minZ;
+        float maxZ = bounds[order[0]].maxZ;
+        for (size_t j=0; j<numVisible; ++j) {
+            minZ = std::min(minZ, bounds[order[j]].minZ);
+            maxZ = std::max(maxZ, bounds[order[j]].maxZ);
+        }
+        _setAutomaticDepthRange(minZ, maxZ);
+    }
+
+    // drawing the nearest polygons first lets the z-buffer test (and hierarchical z) reject
+    // the pixels of the ones behind them instead of drawing them and drawing over them later
+    // ties are broken by index so polygons at the same depth stay in file order
+    // (the same order as a stable sort without the temporary buffer std::stable_sort allocates)
+    if (_sortFrontToBack) {
+        std::sort(order, order + numVisible, [&](size_t a, size_t b) {
+            return bounds[a].minZ < bounds[b].minZ || (bounds[a].minZ == bounds[b].minZ && a < b);
+        });
+    }
+
+    // put each polygon's index in the bin of each tile its bounding box overlaps
+    // the bins are ranges of one array: count the polygons in each tile, then fill the ranges
+    // binStart[tile] to binStart[tile + 1] in order
+    size_t *binStart = _arena.allocate<size_t>(numTiles + 1);
+    std::fill(binStart, binStart + numTiles + 1, size_t(0));
+    for (size_t j=0; j<numVisible; ++j) {
+        const _PixelBounds &b = bounds[order[j]];
+        for (int tileY=b.minY / TileSize; tileY<=b.maxY / TileSize; ++tileY) {
+            for (int tileX=b.minX / TileSize; tileX<=b.maxX / TileSize; ++tileX) {
+                ++binStart[tileY * numTilesX + tileX + 1];
+            }
+        }
+    }
+    for (int tile=0; tile<numTiles; ++tile) {
+        binStart[tile + 1] += binStart[tile];
+    }
+    size_t *binEnd = _arena.allocate<size_t>(numTiles);
+    std::copy(binStart, binStart + numTiles, binEnd);
+    size_t *bins = _arena.allocate<size_t>(binStart[numTiles]);
+    for (size_t j=0; j<numVisible; ++j) {
+        size_t i = order[j];
+        for (int tileY=bounds[i].minY / TileSize; tileY<=bounds[i].maxY / TileSize; ++tileY) {
+            for (int tileX=bounds[i].minX / TileSize; tileX<=bounds[i].maxX / TileSize; ++tileX) {
+                bins[binEnd[tileY * numTilesX + tileX]++] = i;
+            }
+        }
+    }
+
+    // each thread takes the next tile that has not been started yet and draws the polygons in its bin
+    // the tiles do not overlap so the threads never write the same part of the buffers
+    std::atomic<int> nextTile(0);
+    auto rasterizeTiles = [&]() {
+        int tile;
+        while ((tile = nextTile++) < numTiles) {
+            int minX = (tile % numTilesX) * TileSize;
+            int minY = (tile / numTilesX) * TileSize;
+            int maxX = std::min(minX + TileSize, _width) - 1;
+            int maxY = std::min(minY + TileSize, _height) - 1;
+            for (size_t j=binStart[tile]; j<binEnd[tile]; ++j) {
+                size_t i = bins[j];
+                // skip the polygon if the part of it in this tile is behind what is already there
+                // the hierarchical z blocks do not cross tiles so only this thread uses them
+                int polygonMinX = std::max(bounds[i].minX, minX);
+                int polygonMinY = std::max(bounds[i].minY, minY);
+                int polygonMaxX = std::min(bounds[i].maxX, maxX);
+                int polygonMaxY = std::min(bounds[i].maxY, maxY);
+                if (!_isHidden(polygonMinX, polygonMinY, polygonMaxX, polygonMaxY, bounds[i].minZ)) {
+                    ConvexPolygon::scanConvert(this, points[i], numPoints[i], polygons.color(i), polygonMinX, polygonMinY, polygonMaxX, polygonMaxY, firstID == NoPolygon ? NoPolygon : firstID + uint32_t(i));
+                }
+            }
+        }
+    };
+
+    // the pool threads are created by setNumThreads so no threads are created here
+    _threadPool.run(rasterizeTiles);
+}
+
+void ConvexPolygonRasterizer::setNumThreads(int numThreads) {
+    if (numThreads <= 0) {
+        numThreads = int(std::thread::hardware_concurrency());
+    }
+    _threadPool.setNumThreads(numThreads);
+}
+
+size_t ConvexPolygonRasterizer::addPoints(const std::vector<Point3D> &pts, const Color &color) {
+    size_t numVisible = 0;
+
+    for(Point3D point: pts){
+        // skip points outside the buffers (checked before converting to int so huge coordinates cannot overflow)
+        if (!(point.x + .5 >= 0 && point.x + .5 < _width && point.y + .5 >= 0 && point.y + .5 < _height)) {
+            continue;
+        }
+        int x = int(point.x + .5);
+        int y = int(point.y + .5);
+        if (_depthFormat != Float32) {
+            // a point is a span of one pixel
+            numVisible += fillSpan(y, x, point.z, 0.0f, x, x, color);
+            continue;
+        }
+
+        //if the new point is closer than the current z value at the (x, y) coordinate,
+        //overwrite it and its color
+        _clearOldBlocks(y, x, x);
+        if(_zBuffer(y, x) > point.z){
+            _zBuffer(y, x) = point.z;
+            _hiZDirty[(y / HiZBlockSize) * _hiZWidth + x / HiZBlockSize] = true;
+            _colorBuffer[y * _width + x] = color;
+            if (_polygonIDs) {
+                _polygonIDs[y * _width + x] = NoPolygon;
+            }
+            ++numVisible;
+        }
+    }
+    return numVisible;
+}
+
+size_t ConvexPolygonRasterizer::fillSpan(int y, int minX, int maxX, float z, float dz, const Color &color) {
+    int firstX = std::max(minX, 0);
+    int lastX = std::min(maxX, _width - 1);
+    if (y < 0 || y >= _height || firstX > lastX) {
+        return 0;
+    }
+    // write straight into the buffers without making a point for each pixel
+    return fillSpan(y, minX, z, dz, firstX, lastX, color);
+}
+
+void ConvexPolygonRasterizer::setDepthFormat(DepthFormat depthFormat, float nearZ, float farZ) {
+    static const int bits[] = { 32, 16, 24, 32 };
+    _depthFormat = depthFormat;
+    _depthRangeSet = !std::isnan(nearZ) && !std::isnan(farZ);
+    if (_depthRangeSet && depthFormat != Float32 && !(nearZ < farZ)) {
+        throw std::invalid_argument("setDepthFormat: nearZ must be less than farZ");
+    }
+    _automaticDepthRange = !_depthRangeSet;
+    _depthMapping = DepthMapping(bits[depthFormat], _depthRangeSet ? nearZ : 0.0f, _depthRangeSet ? farZ : 1.0f);
+
+    // only keep the buffer for the format being used
+    _depth16 = nullptr;
+    _depth32 = nullptr;
+    if (depthFormat == Float32) {
+        _zBuffer.init(_height, _width, _zBufferLayout);
+    }
+    else {
+        _zBuffer.init(0, 0, Array2D::RowMajor);
+        size_t size = size_t(_width) * _height;
+        if (depthFormat == UInt16) {
+            _depth16 = std::make_unique<uint16_t[]>(size);
+            _spanFillUInt16 = bestSpanFillUInt16Function();
+        }
+        else {
+            _depth32 = std::make_unique<uint32_t[]>(size);
+            _spanFillUInt32 = bestSpanFillUInt32Function(_depthMapping.bits);
+        }
+    }
+    // clear the colors and polygon IDs with the new depths so nothing from before is left in a block marked current
+    for (int blockY=0; blockY<_hiZHeight; ++blockY) {
+        for (int blockX=0; blockX<_hiZWidth; ++blockX) {
+            _clearBlock(blockX, blockY);
+        }
+    }
+}
+
+void ConvexPolygonRasterizer::clear() {
+    _polygons.clear();
+    _polygonBounds.clear();
+    if (_automaticDepthRange) {
+        _depthRangeSet = false;
+    }
+
+    // every block from an older generation is cleared the first time it is used
+    if (++_generation == 0) {
+        // the counter wrapped around so a block untouched for that long would look current
+        _generation = 1;
+        for (int blockY=0; blockY<_hiZHeight; ++blockY) {
+            for (int blockX=0; blockX<_hiZWidth; ++blockX) {
+                _clearBlock(blockX, blockY);
+            }
+        }
+    }
+}
+
+const Color* ConvexPolygonRasterizer::colorBuffer() {
+    // the whole buffer is being used so clear the blocks that have not been yet
+    for (int blockY=0; blockY<_hiZHeight; ++blockY) {
+        for (int blockX=0; blockX<_hiZWidth; ++blockX) {
+            if (_blockGeneration[blockY * _hiZWidth + blockX] != _generation) {
+                _clearBlock(blockX, blockY);
+            }
+        }
+    }
+    return _colorBuffer.get();
+}
+
+void ConvexPolygonRasterizer::setWritePolygonIDs(bool writePolygonIDs) {
+    if (!writePolygonIDs) {
+        _polygonIDs.reset();
+    }
+    else {
+        _polygonIDs = std::make_unique<uint32_t[]>(_width * _height);
+        std::fill_n(_polygonIDs.get(), _width * _height, NoPolygon);
+    }
+}
+
+uint32_t ConvexPolygonRasterizer::polygonAt(int x, int y) const {
+    if (!_polygonIDs || x < 0 || x >= _width || y < 0 || y >= _height) {
+        return NoPolygon;
+    }
+    // a block not used since clear() still has the IDs from before it
+    if (_blockGeneration[(y / HiZBlockSize) * _hiZWidth + x / HiZBlockSize] != _generation) {
+        return NoPolygon;
+    }
+    return _polygonIDs[y * _width + x];
+}
+
+void ConvexPolygonRasterizer::setSortFrontToBack(bool sortFrontToBack) {
+    _sortFrontToBack = sortFrontToBack;
+}
+
+void ConvexPolygonRasterizer::setUseHierarchicalZ(bool useHierarchicalZ) {
+    _useHierarchicalZ = useHierarchicalZ;
+}
+
+float ConvexPolygonRasterizer::depth(int x, int y) const {
+    if (_blockGeneration[(y / HiZBlockSize) * _hiZWidth + x / HiZBlockSize] != _generation) {
+        return INFINITY;
+    }
+    switch (_depthFormat) {
+        case UInt16:
+            return _depthMapping.dequantize(_depth16[y * _width + x]);
+        case UInt24:
+        case UInt32:
+            return _depthMapping.dequantize(_depth32[y * _width + x]);
+        default:
+            return _zBuffer(y, x);
+    }
+}
+
+void ConvexPolygonRasterizer::_setAutomaticDepthRange(float minZ, float maxZ) {
+    if (!_automaticDepthRange) {
+        return;
+    }
+    if (!_depthRangeSet) {
+        // a flat first polygon would give a range of 0 and quantize every depth to 0
+        if (minZ == maxZ) {
+            float pad = 0.5f * std::max(1.0f, std::fabs(minZ));
+            minZ -= pad;
+            maxZ += pad;
+        }
+        _depthMapping = DepthMapping(_depthMapping.bits, minZ, maxZ);
+        _depthRangeSet = true;
+        return;
+    }
+    if (minZ >= _depthMapping.nearZ && maxZ <= _depthMapping.farZ) {
+        return;
+    }
+
+    // widen the range by at least half on each side that is exceeded so it is rarely widened again
+    DepthMapping oldMapping = _depthMapping;
+    float range = oldMapping.farZ - oldMapping.nearZ;
+    float nearZ = minZ < oldMapping.nearZ ? std::min(minZ, oldMapping.nearZ - 0.5f * range) : oldMapping.nearZ;
+    float farZ = maxZ > oldMapping.farZ ? std::max(maxZ, oldMapping.farZ + 0.5f * range) : oldMapping.farZ;
+    _depthMapping = DepthMapping(oldMapping.bits, nearZ, farZ);
+    _requantizeDepths(oldMapping);
+}
+
+void ConvexPolygonRasterizer::_requantizeDepths(const DepthMapping &oldMapping) {
+    if (_depthFormat == Float32) {
+        return;
+    }
+    // only blocks used since clear() hold depths (the others are cleared before they are used)
+    for (int blockY=0; blockY<_hiZHeight; ++blockY) {
+        for (int blockX=0; blockX<_hiZWidth; ++blockX) {
+            int block = blockY * _hiZWidth + blockX;
+            if (_blockGeneration[block] != _generation) {
+                continue;
+            }
+            int minX = blockX * HiZBlockSize;
+            int minY = blockY * HiZBlockSize;
+            int maxX = std::min(minX + HiZBlockSize, _width) - 1;
+            int maxY = std::min(minY + HiZBlockSize, _height) - 1;
+            for (int y=minY; y<=maxY; ++y) {
+                for (int x=minX; x<=maxX; ++x) {
+                    size_t i = size_t(y) * _width + x;
+                    if (_depthFormat == UInt16) {
+                        if (_depth16[i] != oldMapping.maxValue) {
+                            _depth16[i] = uint16_t(_depthMapping.quantize(oldMapping.dequantize(_depth16[i])));
+                        }
+                    }
+                    else if (_depth32[i] != oldMapping.maxValue) {
+                        _depth32[i] = _depthMapping.quantize(oldMapping.dequantize(_depth32[i]));
+                    }
+                }
+            }
+            // the max integer depth of the block changed with the mapping
+            _hiZDirty[block] = true;
+        }
+    }
+}
+
+double ConvexPolygonRasterizer::_depthKey(int x, int y) const {
+    switch (_depthFormat) {
+        case UInt16:
+            return _depth16[y * _width + x];
+        case UInt24:
+        case UInt32:
+            return _depth32[y * _width + x];
+        default:
+            return _zBuffer(y, x);
+    }
+}
+
+bool ConvexPolygonRasterizer::_pixelBounds(const PointArrays &transformedPts, int numPoints, _PixelBounds &bounds) const {
+    if (numPoints == 0) {
+        return false;
+    }
+    float minX, minY, maxX, maxY;
+    minX = maxX = transformedPts.x(0);
+    minY = maxY = transformedPts.y(0);
+    bounds.minZ = bounds.maxZ = transformedPts.z(0);
+    for (int i=1; i<numPoints; ++i) {
+        minX = std::min(minX, transformedPts.x(i));
+        maxX = std::max(maxX, transformedPts.x(i));
+        minY = std::min(minY, transformedPts.y(i));
+        maxY = std::max(maxY, transformedPts.y(i));
+        bounds.minZ = std::min(bounds.minZ, transformedPts.z(i));
+        bounds.maxZ = std::max(bounds.maxZ, transformedPts.z(i));
+    }
+    if (!_overlapsBuffers(minX, minY, maxX, maxY)) {
+        return false;
+    }
+    // clamp before converting to int so far away vertices cannot overflow
+    bounds.minX = int(floor(std::max(minX + 0.5f, 0.0f)));
+    bounds.maxX = int(floor(std::min(maxX + 0.5f, float(_width - 1))));
+    bounds.minY = int(ceil(std::max(minY, 0.0f)));
+    bounds.maxY = int(floor(std::min(maxY, float(_height - 1))));
+    return bounds.minX <= bounds.maxX && bounds.minY <= bounds.maxY;
+}
+
+bool ConvexPolygonRasterizer::_overlapsBuffers(float minX, float minY, float maxX, float maxY) const {
+    // trivially reject polygons entirely outside the buffers (or with coordinates that are not numbers)
+    // span end points are rounded so a polygon can reach half a pixel past its bounding box
+    return maxX + 0.5f >= 0.0f && minX + 0.5f < _width && maxY >= 0.0f && minY <= _height - 1;
+}
+
+PointArrays ConvexPolygonRasterizer::_guardBandPoints(const PointArrays &transformedPts, int &numPoints) {
+    if (ConvexPolygon::isInsideGuardBand(transformedPts, numPoints, _width, _height)) {
+        return transformedPts;
+    }
+    vec4 *clipped = _arena.allocate<vec4>(2 * ConvexPolygon::maxClippedPoints(numPoints));
+    numPoints = ConvexPolygon::clipToBuffers(transformedPts, numPoints, _width, _height, clipped);
+    return clipped;
+}
+
+bool ConvexPolygonRasterizer::_isHidden(int minX, int minY, int maxX, int maxY, float minZ) {
+    if (!_useHierarchicalZ) {
+        return false;
+    }
+    // every depth in the polygon is at least minZ so if no block it touches has anything
+    // farther away than that, no pixel can pass the z-buffer test
+    // (integer depths are rounded the same way for every pixel so compare the rounded value)
+    double minKey = _depthFormat == Float32 ? double(minZ) : double(_depthMapping.quantize(minZ));
+    for (int blockY=minY / HiZBlockSize; blockY<=maxY / HiZBlockSize; ++blockY) {
+        for (int blockX=minX / HiZBlockSize; blockX<=maxX / HiZBlockSize; ++blockX) {
+            if (_hiZMaxDepth(blockX, blockY) > minKey) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+double ConvexPolygonRasterizer::_hiZMaxDepth(int blockX, int blockY) {
+    int block = blockY * _hiZWidth + blockX;
+    if (_blockGeneration[block] != _generation) {
+        return _clearedDepthKey();
+    }
+    if (_hiZDirty[block]) {
+        // something was drawn in the block since its max was found so find it again
+        int minX = blockX * HiZBlockSize;
+        int minY = blockY * HiZBlockSize;
+        int maxX = std::min(minX + HiZBlockSize, _width) - 1;
+        int maxY = std::min(minY + HiZBlockSize, _height) - 1;
+        double maxDepth = -INFINITY;
+        for (int y=minY; y<=maxY; ++y) {
+            for (int x=minX; x<=maxX; ++x) {
+                maxDepth = std::max(maxDepth, _depthKey(x, y));
+            }
+        }
+        _hiZ[block] = maxDepth;
+        _hiZDirty[block] = false;
+    }
+    return _hiZ[block];
+}
+
+void ConvexPolygonRasterizer::_markHiZDirty(int y, int firstX, int lastX) {
+    unsigned char *dirty = &_hiZDirty[(y / HiZBlockSize) * _hiZWidth];
+    for (int blockX=firstX / HiZBlockSize; blockX<=lastX / HiZBlockSize; ++blockX) {
+        dirty[blockX] = true;
+    }
+}
+
+double ConvexPolygonRasterizer::_clearedDepthKey() const {
+    return _depthFormat == Float32 ? double(INFINITY) : double(_depthMapping.maxValue);
+}
+
+void ConvexPolygonRasterizer::_clearBlock(int blockX, int blockY) {
+    int minX = blockX * HiZBlockSize;
+    int minY = blockY * HiZBlockSize;
+    int numColumns = std::min(minX + HiZBlockSize, _width) - minX;
+    int maxY = std::min(minY + HiZBlockSize, _height) - 1;
+    for (int y=minY; y<=maxY; ++y) {
+        std::fill_n(&_colorBuffer[y * _width + minX], numColumns, Color());
+        if (_polygonIDs) {
+            std::fill_n(&_polygonIDs[y * _width + minX], numColumns, NoPolygon);
+        }
+        switch (_depthFormat) {
+            case UInt16:
+                std::fill_n(&_depth16[y * _width + minX], numColumns, uint16_t(_depthMapping.maxValue));
+                break;
+            case UInt24:
+            case UInt32:
+                std::fill_n(&_depth32[y * _width + minX], numColumns, _depthMapping.maxValue);
+                break;
+            default:
+                // the columns of a row of a block are next to each other in either layout
+                std::fill_n(&_zBuffer(y, minX), numColumns, float(INFINITY));
+                break;
+        }
+    }
+    int block = blockY * _hiZWidth + blockX;
+    _hiZ[block] = _clearedDepthKey();
+    _hiZDirty[block] = false;
+    _blockGeneration[block] = _generation;
+}
+
+void ConvexPolygonRasterizer::_clearOldBlocks(int y, int firstX, int lastX) {
+    int blockY = y / HiZBlockSize;
+    const uint32_t *generation = &_blockGeneration[blockY * _hiZWidth];
+    for (int blockX=firstX / HiZBlockSize; blockX<=lastX / HiZBlockSize; ++blockX) {
+        if (generation[blockX] != _generation) {
+            _clearBlock(blockX, blockY);
+        }
+    }
+}
+
+size_t ConvexPolygonRasterizer::_fillIntegerSpan(int y, int minX, float z, float dz, int firstX, int lastX, const Color &color) {
+    Color *colorRow = &_colorBuffer[y * _width];
+    if (_depthFormat == UInt16) {
+        return _spanFillUInt16(&_depth16[y * _width], colorRow, minX, firstX, lastX, z, dz, _depthMapping, color);
+    }
+    return _spanFillUInt32(&_depth32[y * _width], colorRow, minX, firstX, lastX, z, dz, _depthMapping, color);
+}
+
+size_t ConvexPolygonRasterizer::_fillSpanWithIDs(int y, int minX, float z, float dz, int firstX, int lastX, const Color &color, uint32_t polygonID) {
+    Color *colorRow = &_colorBuffer[y * _width];
+    uint32_t *idRow = &_polygonIDs[y * _width];
+    switch (_depthFormat) {
+        case UInt16:
+            return spanFillUInt16IDsScalar(&_depth16[y * _width], colorRow, idRow, minX, firstX, lastX, z, dz, _depthMapping, color, polygonID);
+        case UInt24:
+        case UInt32:
+            return spanFillUInt32IDsScalar(&_depth32[y * _width], colorRow, idRow, minX, firstX, lastX, z, dz, _depthMapping, color, polygonID);
+        default:
+            break;
+    }
+    if (_zBuffer.layout() == Array2D::RowMajor) {
+        return _spanFillIDs(_zBuffer[y], colorRow, idRow, minX, firstX, lastX, z, dz, color, polygonID);
+    }
+    // fill the part of the span in each block separately like _fillTiledSpan
+    size_t numVisible = 0;
+    for (int x = firstX; x <= lastX; ) {
+        int blockX = x - x % Array2D::BlockSize;
+        int blockLastX = std::min(blockX + Array2D::BlockSize - 1, lastX);
+        numVisible += _spanFillIDs(&_zBuffer(y, blockX), colorRow + blockX, idRow + blockX, minX - blockX, x - blockX, blockLastX - blockX, z, dz, color, polygonID);
+        x = blockLastX + 1;
+    }
+    return numVisible;
+}
+
+size_t ConvexPolygonRasterizer::_fillTiledSpan(int y, int minX, float z, float dz, int firstX, int lastX, const Color &color) {
+    size_t numVisible = 0;
+    Color *colorRow = &_colorBuffer[y * _width];
+    for (int x = firstX; x <= lastX; ) {
+        // the columns of this row in this block are next to each other in the z-buffer
+        // so fill them as a span relative to the start of the block
+        int blockX = x - x % Array2D::BlockSize;
+        int blockLastX = std::min(blockX + Array2D::BlockSize - 1, lastX);
+        numVisible += _spanFill(&_zBuffer(y, blockX), colorRow + blockX, minX - blockX, x - blockX, blockLastX - blockX, z, dz, color);
+        x = blockLastX + 1;
+    }
+    return numVisible;
+}
+
+bool ConvexPolygonRasterizer::writePPM(const std::string &filename) const {
+    std::ofstream outfile(filename.c_str(), std::ios::binary);
+    if (!outfile) {
+        return false;
+    }
+
+    outfile << "P6\n" << _width << " " << _height << "\n255\n";
+    // PPM rows go top to bottom but y = 0 is the bottom of the window
+    std::vector<unsigned char> row(_width * 3);
+    for (int y = _height - 1; y >= 0; --y) {
+        for (int x = 0; x < _width; ++x) {
+            Color c = color(x, y);
+            row[3 * x] = (unsigned char)(fmin(fmax(c.r, 0.0f), 1.0f) * 255 + 0.5);
+            row[3 * x + 1] = (unsigned char)(fmin(fmax(c.g, 0.0f), 1.0f) * 255 + 0.5);
+            row[3 * x + 2] = (unsigned char)(fmin(fmax(c.b, 0.0f), 1.0f) * 255 + 0.5);
+        }
+        outfile.write((const char *) &row[0], row.size());
+    }
+    return bool(outfile);
+}
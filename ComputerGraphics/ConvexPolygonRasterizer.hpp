@@ -0,0 +1,363 @@
+//
+//  ConvexPolygonRasterizer.hpp
+//  ComputerGraphics
+//
+//  Created by agent on 10/17/26.
+//  Copyright © 2026 agent. All rights reserved.
+//
+
+#ifndef ConvexPolygonRasterizer_hpp
+#define ConvexPolygonRasterizer_hpp
+
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Point.hpp"
+#include "Color.hpp"
+#include "Array2D.hpp"
+#include "SpanFill.hpp"
+#include "FrameArena.hpp"
+#include "ConvexPolygon.hpp"
+#include "PolygonBatch.hpp"
+#include "ThreadPool.hpp"
+
+struct SceneFileBoundingBox;
+
+/// scan converts ConvexPolygon objects into an in-memory z-buffer and color buffer
+/// does not make any OpenGL calls so it can be used without a window (headless)
+class ConvexPolygonRasterizer {
+public:
+    /// width and height of the square tiles the buffers are split into for multithreaded rasterizing
+    static const int TileSize = 64;
+
+    /// width and height of the blocks the hierarchical z-buffer keeps the max depth of and clear() clears
+    /// (TileSize must be a multiple of it so each block is only used by one thread)
+    static const int HiZBlockSize = 8;
+
+    /// how depths are stored in the z-buffer
+    /// the integer formats map the depth range (see setDepthFormat) onto unsigned integers using a DepthMapping
+    /// (UInt24 is stored in 32 bits so it only saves memory compared to UInt32 in precision, not size)
+    enum DepthFormat { Float32, UInt16, UInt24, UInt32 };
+
+    /// polygon ID of pixels no polygon has been drawn at (see setWritePolygonIDs)
+    static const uint32_t NoPolygon = UINT32_MAX;
+
+    /// rectangle of pixels from (minX, minY) to (maxX, maxY) inclusive
+    struct PixelRectangle {
+        int minX, minY, maxX, maxY;
+
+        /// true if the rectangle has no pixels
+        bool isEmpty() const { return minX > maxX || minY > maxY; }
+    };
+
+    /// constructor
+    /// @param width width of the z-buffer and color buffer
+    /// @param height height of the z-buffer and color buffer
+    /// @param zBufferLayout memory layout of the z-buffer (Tiled keeps tall, narrow, or rotated polygons in fewer cache lines)
+    ConvexPolygonRasterizer(int width, int height, Array2D::Layout zBufferLayout = Array2D::RowMajor);
+
+    /// erase everything drawn (and the stored polygons) so another scene can be rasterized without reallocating
+    /// only increments a generation counter; each HiZBlockSize x HiZBlockSize block of the buffers
+    /// is cleared the first time it is drawn in or read afterward
+    /// an automatic integer depth range (see setDepthFormat) is found again for the next polygons added
+    void clear();
+
+    /// read ConvexPolygon objects from file and rasterize all of them (see addPolygons)
+    /// the file may be a binary scene file (see SceneFile) or a text file
+    /// the file is memory mapped and parsed in place; malformed input is reported with its line number on cerr
+    /// and the polygons before it are still rasterized
+    /// @param filename file containing the polygons
+    /// @return false if the file could not be opened or contains malformed input
+    bool renderFile(const std::string &filename);
+
+    /// rasterize a polygon and store it
+    /// @param polygon the polygon to rasterize
+    void addPolygon(const ConvexPolygon &polygon);
+
+    /// rasterize a polygon without storing it (e.g., for ConvexPolygon::render)
+    /// polygons far outside the buffers are clipped in memory the rasterizer keeps so nothing is allocated per polygon
+    /// @param transformedPts transformed points of the polygon
+    /// @param numPoints number of points
+    /// @param color color for polygon
+    /// @param polygonID ID stored for each pixel drawn if polygon IDs are written
+    void drawPolygon(const PointArrays &transformedPts, int numPoints, const Color &color, uint32_t polygonID = NoPolygon);
+
+    /// rasterize polygons in parallel and store them
+    /// each polygon is put in a bin for each tile its bounding box overlaps and the tiles are rasterized by numThreads() threads
+    /// the polygons in a tile are drawn in order so the result is the same as calling addPolygon for each of them
+    /// (unless sortFrontToBack() is true)
+    /// @param polygons the polygons to rasterize
+    void addPolygons(const std::vector<ConvexPolygon> &polygons);
+
+    /// rasterize the polygons of a batch in parallel the same way (they are drawn straight from the batch and not stored
+    /// so their pixels get the polygon ID NoPolygon)
+    /// @param batch the polygons to rasterize (batch.transform() must have been called since it last changed)
+    void addPolygons(const PolygonBatch &batch);
+
+    /// replace a stored polygon, redrawing only the pixels that can change
+    /// the rectangle covering its old and new bounding boxes is cleared and the part of each stored polygon
+    /// overlapping it is scan converted again (in the order they were added, or front to back if sortFrontToBack())
+    /// so the result is the same as rasterizing all the polygons again (if they were added by one call when sorting)
+    /// anything drawn in the rectangle that is not a stored polygon (PolygonBatch polygons, addPoints, fillSpan) is erased
+    /// throws std::out_of_range if index is not less than polygons().size()
+    /// @param index index of the polygon in polygons()
+    /// @param polygon the new polygon
+    /// @return the rectangle that was redrawn (empty if the polygon is outside the buffers before and after)
+    PixelRectangle replacePolygon(size_t index, const ConvexPolygon &polygon);
+
+    /// set how depths are stored, clearing the z-buffer and color buffer (so call it before adding polygons)
+    /// integer formats always use the RowMajor layout and free the float z-buffer
+    /// (switching back to Float32 uses the layout given to the constructor again)
+    /// if nearZ or farZ is NAN the range of transformed depths of the first polygons added is used
+    /// and widened when later polygons are outside it (requantizing the depths already drawn)
+    /// throws std::invalid_argument for an integer format if nearZ is not less than farZ
+    /// @param depthFormat how depths are stored
+    /// @param nearZ depth mapped to 0 by the integer formats
+    /// @param farZ depth mapped to the largest value drawn by the integer formats
+    void setDepthFormat(DepthFormat depthFormat, float nearZ = NAN, float farZ = NAN);
+
+    /// how depths are stored in the z-buffer
+    DepthFormat depthFormat() const { return _depthFormat; }
+
+    /// mapping of depths to integers for the integer depth formats
+    const DepthMapping& depthMapping() const { return _depthMapping; }
+
+    /// set whether polygons are tested against the max depth of each HiZBlockSize x HiZBlockSize block
+    /// before they are scan converted, skipping the ones that are entirely behind what has been drawn
+    /// @param useHierarchicalZ true to test (the default)
+    void setUseHierarchicalZ(bool useHierarchicalZ);
+
+    /// true if polygons are tested against the hierarchical z-buffer before they are scan converted
+    bool useHierarchicalZ() const { return _useHierarchicalZ; }
+
+    /// set whether addPolygons draws polygons in order of their nearest transformed vertex instead of the order given
+    /// drawing front to back means most pixels of polygons behind others fail the z-buffer test instead of being overdrawn
+    /// pixels where polygons are at exactly the same depth may be a different color than drawing them in order
+    /// @param sortFrontToBack true to sort (default is false)
+    void setSortFrontToBack(bool sortFrontToBack);
+
+    /// true if addPolygons draws polygons front to back
+    bool sortFrontToBack() const { return _sortFrontToBack; }
+
+    /// set whether the index of the polygon drawn at each pixel is stored so polygonAt can find it
+    /// clears the polygon IDs (so call it before adding polygons)
+    /// with the integer depth formats pixels are depth tested one at a time instead of with SIMD instructions while it is on
+    /// @param writePolygonIDs true to store polygon IDs (default is false)
+    void setWritePolygonIDs(bool writePolygonIDs);
+
+    /// true if the index of the polygon drawn at each pixel is stored
+    bool writePolygonIDs() const { return _polygonIDs != nullptr; }
+
+    /// index in polygons() of the front-most polygon at (x, y)
+    /// @return NoPolygon if no stored polygon was drawn there (including where a PolygonBatch polygon is in front),
+    /// (x, y) is outside the buffers, or polygon IDs are not written
+    uint32_t polygonAt(int x, int y) const;
+
+    /// set number of threads addPolygons uses
+    /// the threads are created here and kept (waiting when there is nothing to rasterize) until the number changes
+    /// @param numThreads number of threads (0 uses the number of hardware threads)
+    void setNumThreads(int numThreads);
+
+    /// number of threads addPolygons uses
+    int numThreads() const { return _threadPool.numThreads(); }
+
+    /// z-buffer test points, storing the depth and color of each point closer than what is already at its (x, y)
+    /// @param pts vector of Point3D to test
+    /// @param color color of the points
+    /// @return number of points that passed the z-buffer test
+    size_t addPoints(const std::vector<Point3D> &pts, const Color &color);
+
+    /// z-buffer test a horizontal span of pixels, storing the depth and color of each one closer than what is already there
+    /// the part of the span outside the buffers is ignored
+    /// uses SIMD instructions when the CPU supports them
+    /// @param y row of the span
+    /// @param minX first column of the span
+    /// @param maxX last column of the span (inclusive)
+    /// @param z depth at minX
+    /// @param dz change in depth for each column
+    /// @param color color of the span
+    /// @return number of pixels that passed the z-buffer test
+    size_t fillSpan(int y, int minX, int maxX, float z, float dz, const Color &color);
+
+    /// z-buffer test columns firstX through lastX of a horizontal span
+    /// does not check that the columns are inside the buffers
+    /// @param y row of the span
+    /// @param minX first column of the span
+    /// @param z depth at minX
+    /// @param dz change in depth for each column
+    /// @param firstX first column to test
+    /// @param lastX last column to test (inclusive)
+    /// @param color color of the span
+    /// @param polygonID ID stored for each pixel that passes if polygon IDs are written
+    /// @return number of pixels that passed the z-buffer test
+    size_t fillSpan(int y, int minX, float z, float dz, int firstX, int lastX, const Color &color, uint32_t polygonID = NoPolygon) {
+        size_t numVisible;
+        _clearOldBlocks(y, firstX, lastX);
+        if (_polygonIDs) {
+            numVisible = _fillSpanWithIDs(y, minX, z, dz, firstX, lastX, color, polygonID);
+        }
+        else if (_depthFormat != Float32) {
+            numVisible = _fillIntegerSpan(y, minX, z, dz, firstX, lastX, color);
+        }
+        else if (_zBuffer.layout() == Array2D::Tiled) {
+            numVisible = _fillTiledSpan(y, minX, z, dz, firstX, lastX, color);
+        }
+        else {
+            numVisible = _spanFill(_zBuffer[y], &_colorBuffer[y * _width], minX, firstX, lastX, z, dz, color);
+        }
+        if (numVisible > 0) {
+            _markHiZDirty(y, firstX, lastX);
+        }
+        return numVisible;
+    }
+
+    /// width of the buffers
+    int width() const { return _width; }
+
+    /// height of the buffers
+    int height() const { return _height; }
+
+    /// depth stored at (x, y) (INFINITY if nothing drawn there)
+    /// for the integer depth formats this is the depth the stored integer represents
+    float depth(int x, int y) const;
+
+    /// memory layout of the z-buffer
+    Array2D::Layout zBufferLayout() const { return _zBuffer.layout(); }
+
+    /// color stored at (x, y) (black if nothing drawn there)
+    Color color(int x, int y) const {
+        return _blockGeneration[(y / HiZBlockSize) * _hiZWidth + x / HiZBlockSize] == _generation ? _colorBuffer[y * _width + x] : Color();
+    }
+
+    /// color buffer with width * height colors, row by row starting with y = 0
+    /// (finishes clearing any blocks not used since clear() was called)
+    const Color* colorBuffer();
+
+    /// polygons that have been rasterized and stored (polygons().polygon(i) gives polygon i as a ConvexPolygon)
+    const PolygonBatch& polygons() const { return _polygons; }
+
+    /// write the color buffer as a binary PPM image (top row of image is y = height - 1)
+    /// @param filename file to write
+    /// @return false if the file could not be written
+    bool writePPM(const std::string &filename) const;
+
+private:
+    /// pixels a polygon can cover clipped to the buffers and its min depth
+    struct _PixelBounds {
+        int minX, minY, maxX, maxY;
+        float minZ, maxZ;
+    };
+
+    /// find the bounds of transformed points
+    /// @return false if none of the polygon is inside the buffers
+    bool _pixelBounds(const PointArrays &transformedPts, int numPoints, _PixelBounds &bounds) const;
+
+    /// true if any of the rectangle from (minX, minY) to (maxX, maxY) in window coordinates can be drawn in the buffers
+    bool _overlapsBuffers(float minX, float minY, float maxX, float maxY) const;
+
+    /// set the integer depth range from the depths of polygons being added if setDepthFormat did not give one
+    /// (widening it if it was already set from earlier polygons and minZ or maxZ is outside it)
+    void _setAutomaticDepthRange(float minZ, float maxZ);
+
+    /// convert the integer depths drawn since clear() from oldMapping to _depthMapping
+    void _requantizeDepths(const DepthMapping &oldMapping);
+
+    /// stored depth at (x, y) as a double so float and integer depths can be compared the same way
+    double _depthKey(int x, int y) const;
+
+    /// true if every pixel from (minX, minY) to (maxX, maxY) already has a depth <= minZ
+    bool _isHidden(int minX, int minY, int maxX, int maxY, float minZ);
+
+    /// max depth in a block of the hierarchical z-buffer, finding it again if the block is dirty
+    double _hiZMaxDepth(int blockX, int blockY);
+
+    /// mark the hierarchical z blocks a span of row y touched as needing their max depth found again
+    void _markHiZDirty(int y, int firstX, int lastX);
+
+    /// depth (or integer depth) of a cleared pixel as a double
+    double _clearedDepthKey() const;
+
+    /// set the depths of a block to the cleared depth and its colors to black and make it current
+    void _clearBlock(int blockX, int blockY);
+
+    /// clear the blocks a span of row y touches that have not been used since clear() was called
+    void _clearOldBlocks(int y, int firstX, int lastX);
+
+    /// fillSpan for the integer depth formats
+    size_t _fillIntegerSpan(int y, int minX, float z, float dz, int firstX, int lastX, const Color &color);
+
+    /// fillSpan for the Tiled z-buffer layout, filling the part of the span in each block separately
+    size_t _fillTiledSpan(int y, int minX, float z, float dz, int firstX, int lastX, const Color &color);
+
+    /// fillSpan when polygon IDs are written
+    size_t _fillSpanWithIDs(int y, int minX, float z, float dz, int firstX, int lastX, const Color &color, uint32_t polygonID);
+
+    /// rasterize the stored polygons in [first, last) by tiles (see addPolygons)
+    /// @param boxes transformed bounding box of each polygon from a scene file (nullptr if there are none)
+    void _rasterizePolygons(size_t first, size_t last, const SceneFileBoundingBox *boxes = nullptr);
+
+    /// rasterize polygons by tiles (see addPolygons)
+    /// Polygons has numPoints(i), color(i), and transformedPoints(i) like PolygonBatch
+    /// @param storedBounds where to keep the bounds of the polygons (nullptr if they are not kept)
+    /// @param firstID polygon ID of the first polygon (the others are numbered after it, unless it is NoPolygon)
+    /// @param boxes transformed bounding box of each polygon so the ones outside the buffers are rejected
+    /// without reading their points (nullptr to find the bounds of every polygon from its points)
+    template <typename Polygons>
+    void _rasterizePolygons(const Polygons &polygons, size_t numPolygons, _PixelBounds *storedBounds, uint32_t firstID, const SceneFileBoundingBox *boxes = nullptr);
+
+    /// rasterize a polygon (see drawPolygon)
+    /// @return its bounds (empty if none of it is inside the buffers)
+    _PixelBounds _drawPolygon(const PointArrays &transformedPts, int numPoints, const Color &color, uint32_t polygonID);
+
+    /// bounds of a polygon outside the buffers (minX > maxX)
+    static _PixelBounds _emptyBounds();
+
+    /// the points scanConvert draws a polygon with: transformedPts if they are inside the guard band,
+    /// otherwise the polygon clipped to the buffers in _arena memory (valid until the next _arena.reset())
+    /// @param numPoints number of points of transformedPts, changed to the number of points returned
+    PointArrays _guardBandPoints(const PointArrays &transformedPts, int &numPoints);
+
+    /// clear a rectangle and scan convert the part of each stored polygon inside it again
+    void _redrawRectangle(const PixelRectangle &rectangle);
+
+    /// set the depths in a rectangle to the cleared depth and its colors to black
+    void _clearRectangle(const PixelRectangle &rectangle);
+
+    int _width, _height;
+    Array2D _zBuffer;
+    // layout given to the constructor (the integer formats do not use it, so it is kept for switching back to Float32)
+    Array2D::Layout _zBufferLayout;
+    std::unique_ptr<Color[]> _colorBuffer;
+    DepthFormat _depthFormat;
+    DepthMapping _depthMapping;
+    bool _depthRangeSet;
+    bool _automaticDepthRange;
+    std::unique_ptr<uint16_t[]> _depth16;
+    std::unique_ptr<uint32_t[]> _depth32;
+    SpanFillUInt16Function _spanFillUInt16;
+    SpanFillUInt32Function _spanFillUInt32;
+    // max depth (or integer depth) of each HiZBlockSize x HiZBlockSize block (only valid when the block is not dirty)
+    std::vector<double> _hiZ;
+    std::vector<unsigned char> _hiZDirty;
+    int _hiZWidth, _hiZHeight;
+    // clear() number each block was last cleared for (blocks with an older one need to be cleared before being used)
+    std::vector<uint32_t> _blockGeneration;
+    uint32_t _generation;
+    bool _useHierarchicalZ;
+    bool _sortFrontToBack;
+    SpanFillFunction _spanFill;
+    SpanFillIDsFunction _spanFillIDs;
+    ThreadPool _threadPool;
+    // stored polygons in a few arrays rather than a ConvexPolygon with its own vectors for each one
+    PolygonBatch _polygons;
+    // index of the polygon drawn at each pixel (nullptr unless setWritePolygonIDs(true))
+    std::unique_ptr<uint32_t[]> _polygonIDs;
+    // bounds of each stored polygon (empty ones for polygons outside the buffers)
+    std::vector<_PixelBounds> _polygonBounds;
+    // scratch memory for binning polygons (reset each time polygons are rasterized)
+    FrameArena _arena;
+};
+
+#endif /* ConvexPolygonRasterizer_hpp */
@@ -6,45 +6,36 @@
 //  Copyright © 2020 David M Reed. All rights reserved.
 //
 
-#include <fstream>
 #include "ConvexPolygon.hpp"
 #include "ConvexPolygonRenderer.hpp"
 
-ConvexPolygonRenderer::ConvexPolygonRenderer(std::string windowTitle, int width, int height, std::string filename) : Renderer(windowTitle, width, height) {
-    
-    std::ifstream infile(filename.c_str());
-    ConvexPolygon polygon;
-    _zBuffer.init(height, width);
-    for(int y = 0; y < height; y++){
-        for(int x = 0; x < width; x++){
-            _zBuffer[y][x] = INFINITY;
-        }
-    }
+ConvexPolygonRenderer::ConvexPolygonRenderer(std::string windowTitle, int width, int height, std::string filename) : Renderer(windowTitle, width, height), _rasterizer(width, height) {
 
-    // while not end of file read ConvexPolygon objects from file stream
-    while (infile >> polygon) {
-        // render it
-        polygon.render(this);
-        // store it in case we want to use it in the future
-        _convexPolygons.push_back(polygon);
-    }
-    infile.close();
+    // rasterize every polygon so the z-buffer resolves which one is visible at each pixel
+    // keeping the index of the polygon at each pixel so clicks can pick it
+    _rasterizer.setWritePolygonIDs(true);
+    _rasterizer.renderFile(filename);
+
+    // and draw the resulting colors as a single image so draw cost does not depend on number of polygons
+    _image = addImage(_rasterizer.width(), _rasterizer.height(), _rasterizer.colorBuffer());
 }
 
-//overrides Rendered addPoints to utilize zBuffer
-size_t ConvexPolygonRenderer::addPoints(const std::vector<Point3D> &pts, const Color &color, float pointSize, const mat4 &objectTransformation) {
-    std::vector<Point3D> closePoints;
-    
-    for(Point3D point: pts){
-        //if the new point is closer than the current z value at the (x, y) coordinate,
-        //overwrite it and add it to be drawn
+void ConvexPolygonRenderer::mouseButtonCallback(GLFWwindow* window, int button, int action, int mods, double xPos, double yPos) {
+    Renderer::mouseButtonCallback(window, button, action, mods, xPos, yPos);
 
-        if(_zBuffer[int(point.y + .5)][int(point.x + .5)] > point.z){
-            _zBuffer[int(point.y + .5)][int(point.x + .5)] = point.z;
-            closePoints.push_back(point);
+    if (button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_PRESS) {
+        // window row 0 is at the top and buffer row 0 is at the bottom
+        uint32_t polygon = _rasterizer.polygonAt(int(xPos), windowHeight() - 1 - int(yPos));
+        if (polygon != ConvexPolygonRasterizer::NoPolygon) {
+            std::cerr << "polygon: " << polygon << std::endl;
         }
     }
-    
-    //call Rendered addPoints with the new points to be drawn
-    return Renderer::addPoints(closePoints, color, pointSize, objectTransformation);
+}
+
+void ConvexPolygonRenderer::replacePolygon(size_t index, const ConvexPolygon &polygon) {
+    ConvexPolygonRasterizer::PixelRectangle dirty = _rasterizer.replacePolygon(index, polygon);
+    if (!dirty.isEmpty()) {
+        auto image = std::static_pointer_cast<ImageDrawable>((*this)[_image]);
+        image->updatePixels(dirty.minX, dirty.minY, dirty.maxX, dirty.maxY, _rasterizer.colorBuffer());
+    }
 }
@@ -0,0 +1,63 @@
+//
+//  FrameArena.cpp
+//  ComputerGraphics
+//
+//  Created by agent on 10/17/26.
+//  Copyright © 2026 agent. All rights reserved.
+//
+
+#include <algorithm>
+#include <cstdint>
+#include "FrameArena.hpp"
+
+FrameArena::FrameArena(size_t blockSize) {
+    _Block block;
+    block.data = std::make_unique<char[]>(blockSize);
+    block.size = blockSize;
+    _blocks.push_back(std::move(block));
+    _currentBlock = 0;
+    _used = 0;
+}
+
+void FrameArena::reset() {
+    if (_currentBlock > 0) {
+        // replace the blocks with one so the next frame fits without adding any
+        size_t size = capacity();
+        _blocks.clear();
+        _Block block;
+        block.data = std::make_unique<char[]>(size);
+        block.size = size;
+        _blocks.push_back(std::move(block));
+    }
+    _currentBlock = 0;
+    _used = 0;
+}
+
+size_t FrameArena::capacity() const {
+    size_t size = 0;
+    for (const _Block &block: _blocks) {
+        size += block.size;
+    }
+    return size;
+}
+
+void* FrameArena::_allocate(size_t size, size_t alignment) {
+    while (true) {
+        _Block &block = _blocks[_currentBlock];
+        uintptr_t start = reinterpret_cast<uintptr_t>(block.data.get());
+        uintptr_t aligned = (start + _used + alignment - 1) & ~uintptr_t(alignment - 1);
+        if (aligned + size <= start + block.size) {
+            _used = aligned + size - start;
+            return reinterpret_cast<void*>(aligned);
+        }
+        // does not fit so move to the next block, adding one if needed
+        ++_currentBlock;
+        _used = 0;
+        if (_currentBlock == _blocks.size()) {
+            _Block newBlock;
+            newBlock.size = std::max(block.size * 2, size + alignment);
+            newBlock.data = std::make_unique<char[]>(newBlock.size);
+            _blocks.push_back(std::move(newBlock));
+        }
+    }
+}
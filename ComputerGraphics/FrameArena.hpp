@@ -0,0 +1,57 @@
+//
+//  FrameArena.hpp
+//  ComputerGraphics
+//
+//  Created by agent on 10/17/26.
+//  Copyright © 2026 agent. All rights reserved.
+//
+
+#ifndef FrameArena_hpp
+#define FrameArena_hpp
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+/// bump allocator for scratch memory that is only needed until the end of a frame
+/// allocating just moves a pointer forward and reset() frees everything at once, keeping the memory
+/// so once it has grown to the size a frame needs, later frames do not use the heap at all
+class FrameArena {
+public:
+    /// @param blockSize size in bytes of the first block of memory (more are added as needed)
+    FrameArena(size_t blockSize = 1 << 16);
+
+    /// allocate uninitialized memory for count objects of type T
+    /// only for types that do not need a destructor since none are called
+    /// @param count number of objects
+    /// @return memory aligned for T that is valid until reset()
+    template <typename T>
+    T* allocate(size_t count) {
+        static_assert(std::is_trivially_destructible<T>::value, "FrameArena does not call destructors");
+        return static_cast<T*>(_allocate(count * sizeof(T), alignof(T)));
+    }
+
+    /// free everything allocated since the last reset
+    /// if more than one block was needed they are replaced by one block big enough for all of them
+    void reset();
+
+    /// number of bytes of memory the arena has
+    size_t capacity() const;
+
+private:
+    FrameArena(const FrameArena &);
+    FrameArena& operator=(const FrameArena &);
+
+    void* _allocate(size_t size, size_t alignment);
+
+    struct _Block {
+        std::unique_ptr<char[]> data;
+        size_t size;
+    };
+    std::vector<_Block> _blocks;
+    size_t _currentBlock;
+    size_t _used;
+};
+
+#endif /* FrameArena_hpp */
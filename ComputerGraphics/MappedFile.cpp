@@ -0,0 +1,84 @@
+//
+//  MappedFile.cpp
+//  ComputerGraphics
+//
+//  Created by agent on 10/17/26.
+//  Copyright © 2026 agent. All rights reserved.
+//
+
+#include "MappedFile.hpp"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(const std::string &filename) {
+    _isOpen = false;
+    _data = nullptr;
+    _size = 0;
+
+#ifdef _WIN32
+    _mappingHandle = NULL;
+    _fileHandle = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (_fileHandle == INVALID_HANDLE_VALUE) {
+        return;
+    }
+    LARGE_INTEGER fileSize;
+    GetFileSizeEx(_fileHandle, &fileSize);
+    _size = size_t(fileSize.QuadPart);
+    _isOpen = true;
+    // an empty file cannot be mapped
+    if (_size > 0) {
+        _mappingHandle = CreateFileMappingA(_fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (_mappingHandle != NULL) {
+            _data = (const char *) MapViewOfFile(_mappingHandle, FILE_MAP_READ, 0, 0, 0);
+        }
+        _isOpen = _data != nullptr;
+    }
+#else
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return;
+    }
+    struct stat fileInfo;
+    if (fstat(fd, &fileInfo) == 0) {
+        _size = size_t(fileInfo.st_size);
+        _isOpen = true;
+        // an empty file cannot be mapped
+        if (_size > 0) {
+            void *address = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (address != MAP_FAILED) {
+                // the file is normally read from front to back
+                madvise(address, _size, MADV_SEQUENTIAL);
+                _data = (const char *) address;
+            }
+            _isOpen = _data != nullptr;
+        }
+    }
+    // the mapping stays valid after the file is closed
+    close(fd);
+#endif
+}
+
+MappedFile::~MappedFile() noexcept {
+#ifdef _WIN32
+    if (_data != nullptr) {
+        UnmapViewOfFile(_data);
+    }
+    if (_mappingHandle != NULL) {
+        CloseHandle(_mappingHandle);
+    }
+    if (_fileHandle != INVALID_HANDLE_VALUE) {
+        CloseHandle(_fileHandle);
+    }
+#else
+    if (_data != nullptr) {
+        munmap((void *) _data, _size);
+    }
+#endif
+}
@@ -0,0 +1,46 @@
+//
+//  MappedFile.hpp
+//  ComputerGraphics
+//
+//  Created by agent on 10/17/26.
+//  Copyright © 2026 agent. All rights reserved.
+//
+
+#ifndef MappedFile_hpp
+#define MappedFile_hpp
+
+#include <cstddef>
+#include <string>
+
+/// read-only memory mapping of an entire file
+class MappedFile {
+public:
+    /// map the file at filename into memory
+    /// @param filename path to the file
+    MappedFile(const std::string &filename);
+
+    ~MappedFile() noexcept;
+
+    /// true if the file was opened and mapped
+    bool isOpen() const { return _isOpen; }
+
+    /// first byte of the file (nullptr if not open or empty)
+    const char* data() const { return _data; }
+
+    /// number of bytes in the file
+    size_t size() const { return _size; }
+
+private:
+    MappedFile(const MappedFile &);
+    MappedFile& operator=(const MappedFile &);
+
+    bool _isOpen;
+    const char *_data;
+    size_t _size;
+#ifdef _WIN32
+    void *_fileHandle;
+    void *_mappingHandle;
+#endif
+};
+
+#endif /* MappedFile_hpp */
@@ -0,0 +1,210 @@
+//
+//  PolygonBatch.cpp
+//  ComputerGraphics
+//
+//  Created by agent on 10/17/26.
+//  Copyright © 2026 agent. All rights reserved.
+//
+
+#include "PolygonBatch.hpp"
+
+PolygonBatch::PolygonBatch() {
+    _firstPoint.push_back(0);
+    _numTransformed = 0;
+}
+
+void PolygonBatch::add(const ConvexPolygon &polygon) {
+    const std::vector<Point3D> &pts = polygon.points();
+    add(pts.data(), pts.size(), polygon.color(), polygon.scaleX(), polygon.scaleY(), polygon.translateX(), polygon.translateY(), polygon.theta());
+}
+
+void PolygonBatch::add(const Point3D *pts, size_t numPts, const Color &color, const float scaleX, const float scaleY, const float translateX, const float translateY, const float theta) {
+    uint32_t polygon = uint32_t(size());
+    for (size_t i=0; i<numPts; ++i) {
+        _xs.push_back(pts[i].x);
+        _ys.push_back(pts[i].y);
+        _zs.push_back(pts[i].z);
+        _pointPolygon.push_back(polygon);
+    }
+    _firstPoint.push_back(uint32_t(_xs.size()));
+    _colors.push_back(color);
+    _scaleX.push_back(scaleX);
+    _scaleY.push_back(scaleY);
+    _translateX.push_back(translateX);
+    _translateY.push_back(translateY);
+    _theta.push_back(theta);
+}
+
+void PolygonBatch::set(size_t i, const ConvexPolygon &polygon) {
+    const std::vector<Point3D> &pts = polygon.points();
+    set(i, pts.data(), pts.size(), polygon.color(), polygon.scaleX(), polygon.scaleY(), polygon.translateX(), polygon.translateY(), polygon.theta());
+}
+
+/// make the range of count elements of v at first newCount elements long, moving the elements after it
+template <typename T>
+static void resizeRange(std::vector<T> &v, size_t first, size_t count, size_t newCount) {
+    if (newCount > count) {
+        v.insert(v.begin() + (first + count), newCount - count, T());
+    }
+    else {
+        v.erase(v.begin() + (first + newCount), v.begin() + (first + count));
+    }
+}
+
+void PolygonBatch::set(size_t i, const Point3D *pts, size_t numPts, const Color &color, const float scaleX, const float scaleY, const float translateX, const float translateY, const float theta) {
+    uint32_t first = _firstPoint[i];
+    size_t oldNumPts = numPoints(i);
+    if (numPts != oldNumPts) {
+        // make room for the new points by moving the points of the polygons after it
+        resizeRange(_xs, first, oldNumPts, numPts);
+        resizeRange(_ys, first, oldNumPts, numPts);
+        resizeRange(_zs, first, oldNumPts, numPts);
+        resizeRange(_pointPolygon, first, oldNumPts, numPts);
+        // the transformed points of the polygons after it move with them (they only exist up to _numTransformed)
+        if (i < _numTransformed) {
+            resizeRange(_transformedXs, first, oldNumPts, numPts);
+            resizeRange(_transformedYs, first, oldNumPts, numPts);
+        }
+        for (size_t j=i + 1; j<_firstPoint.size(); ++j) {
+            _firstPoint[j] = uint32_t(_firstPoint[j] + numPts - oldNumPts);
+        }
+    }
+    for (size_t j=0; j<numPts; ++j) {
+        _xs[first + j] = pts[j].x;
+        _ys[first + j] = pts[j].y;
+        _zs[first + j] = pts[j].z;
+        _pointPolygon[first + j] = uint32_t(i);
+    }
+    _colors[i] = color;
+    setTransform(i, scaleX, scaleY, translateX, translateY, theta);
+}
+
+void PolygonBatch::setTransform(size_t i, const float scaleX, const float scaleY, const float translateX, const float translateY, const float theta) {
+    _scaleX[i] = scaleX;
+    _scaleY[i] = scaleY;
+    _translateX[i] = translateX;
+    _translateY[i] = translateY;
+    _theta[i] = theta;
+    if (i < _numTransformed) {
+        _changed.push_back(i);
+    }
+}
+
+void PolygonBatch::reserve(size_t numPolygons, size_t numPoints) {
+    _xs.reserve(numPoints);
+    _ys.reserve(numPoints);
+    _zs.reserve(numPoints);
+    _pointPolygon.reserve(numPoints);
+    _transformedXs.reserve(numPoints);
+    _transformedYs.reserve(numPoints);
+    _firstPoint.reserve(numPolygons + 1);
+    _colors.reserve(numPolygons);
+    _scaleX.reserve(numPolygons);
+    _scaleY.reserve(numPolygons);
+    _translateX.reserve(numPolygons);
+    _translateY.reserve(numPolygons);
+    _theta.reserve(numPolygons);
+    for (std::vector<float> *coefficients: { &_a, &_b, &_c, &_d, &_e, &_f }) {
+        coefficients->reserve(numPolygons);
+    }
+}
+
+void PolygonBatch::clear() {
+    _xs.clear();
+    _ys.clear();
+    _zs.clear();
+    _firstPoint.resize(1);
+    _pointPolygon.clear();
+    _colors.clear();
+    _scaleX.clear();
+    _scaleY.clear();
+    _translateX.clear();
+    _translateY.clear();
+    _theta.clear();
+    for (std::vector<float> *coefficients: { &_a, &_b, &_c, &_d, &_e, &_f }) {
+        coefficients->clear();
+    }
+    _transformedXs.clear();
+    _transformedYs.clear();
+    _numTransformed = 0;
+    _changed.clear();
+}
+
+ConvexPolygon PolygonBatch::polygon(size_t i) const {
+    std::vector<Point3D> pts;
+    pts.reserve(numPoints(i));
+    for (uint32_t j=_firstPoint[i]; j<_firstPoint[i + 1]; ++j) {
+        pts.push_back(Point3D(_xs[j], _ys[j], _zs[j]));
+    }
+    return ConvexPolygon(pts, _colors[i], _scaleX[i], _scaleY[i], _translateX[i], _translateY[i], _theta[i]);
+}
+
+void PolygonBatch::transform() {
+    size_t numPolygons = size();
+    for (std::vector<float> *coefficients: { &_a, &_b, &_c, &_d, &_e, &_f }) {
+        coefficients->resize(numPolygons);
+    }
+    _transformedXs.resize(numPoints());
+    _transformedYs.resize(numPoints());
+
+    // first the transforms of the polygons that changed, then their points
+    for (size_t i: _changed) {
+        _composeTransform(i);
+    }
+    for (size_t i=_numTransformed; i<numPolygons; ++i) {
+        _composeTransform(i);
+    }
+    for (size_t i: _changed) {
+        _transformPoints(_firstPoint[i], _firstPoint[i + 1]);
+    }
+    _transformPoints(_firstPoint[_numTransformed], _firstPoint[numPolygons]);
+    _changed.clear();
+    _numTransformed = numPolygons;
+}
+
+void PolygonBatch::_composeTransform(size_t i) {
+    uint32_t first = _firstPoint[i];
+    uint32_t last = _firstPoint[i + 1];
+
+    // center point the same way as ConvexPolygon::centerPoint
+    Point3D center;
+    for (uint32_t j=first; j<last; ++j) {
+        center.x += _xs[j];
+        center.y += _ys[j];
+    }
+    size_t numPoints = last - first;
+    center.x /= numPoints;
+    center.y /= numPoints;
+
+    // ConvexPolygon composes Translate(translate) * Translate(center) * RotateZ * Scale * Translate(-center)
+    // most of those products are multiplies by 0 or 1 so compute only the terms that are not,
+    // in the same order the mat4 products add them so the results are identical
+    mat4 rotate = RotateZ(_theta[i]);
+    float cosine = rotate[0][0];
+    float sine = rotate[1][0];
+    float tx = center.x + _translateX[i];
+    float ty = center.y + _translateY[i];
+    _a[i] = cosine * _scaleX[i];
+    _b[i] = -sine * _scaleY[i];
+    _d[i] = sine * _scaleX[i];
+    _e[i] = cosine * _scaleY[i];
+    _c[i] = (_a[i] * -center.x + _b[i] * -center.y) + tx;
+    _f[i] = (_d[i] * -center.x + _e[i] * -center.y) + ty;
+}
+
+void PolygonBatch::_transformPoints(uint32_t first, uint32_t last) {
+    const float *xs = _xs.data();
+    const float *ys = _ys.data();
+    const uint32_t *polygon = _pointPolygon.data();
+    const float *a = _a.data(), *b = _b.data(), *c = _c.data();
+    const float *d = _d.data(), *e = _e.data(), *f = _f.data();
+    float *outX = _transformedXs.data();
+    float *outY = _transformedYs.data();
+    // one loop over the points of many polygons with no per polygon setup or branches
+    // (each point gathers its polygon's coefficients) so the compiler can vectorize it
+    for (uint32_t j=first; j<last; ++j) {
+        uint32_t p = polygon[j];
+        outX[j] = a[p] * xs[j] + b[p] * ys[j] + c[p];
+        outY[j] = d[p] * xs[j] + e[p] * ys[j] + f[p];
+    }
+}
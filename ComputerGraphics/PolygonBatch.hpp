@@ -0,0 +1,130 @@
+//
+//  PolygonBatch.hpp
+//  ComputerGraphics
+//
+//  Created by agent on 10/17/26.
+//  Copyright © 2026 agent. All rights reserved.
+//
+
+#ifndef PolygonBatch_hpp
+#define PolygonBatch_hpp
+
+#include <cstdint>
+#include <vector>
+
+#include "Angel.hpp"
+#include "Point.hpp"
+#include "Color.hpp"
+#include "ConvexPolygon.hpp"
+
+/// stores many convex polygons in a few contiguous arrays instead of a vector of points per polygon
+/// the coordinates of all the points are in separate x, y, and z arrays (structure of arrays) with an offset
+/// table giving each polygon's first point, and the color and transform parameters are one array each
+/// transform() composes each changed polygon's affine transform into per polygon coefficient arrays, then
+/// transforms the points with one loop over the coordinate arrays (looking up each point's polygon) into
+/// transformed x and y arrays the rasterizer reads directly
+class PolygonBatch {
+public:
+    /// create an empty batch
+    PolygonBatch();
+
+    /// add a copy of a polygon to the end of the batch
+    /// @param polygon polygon to add
+    void add(const ConvexPolygon &polygon);
+
+    /// add a polygon to the end of the batch
+    /// @param pts array of coordinate points (must form a convex polygon)
+    /// @param numPts number of points in pts
+    /// @param color color for polygon
+    /// @param scaleX x-scale factor
+    /// @param scaleY y-scale factor
+    /// @param translateX x-translate amount
+    /// @param translateY y-translate amount
+    /// @param theta - rotate Z amount in degrees
+    void add(const Point3D *pts, size_t numPts, const Color &color, const float scaleX = 1.0, const float scaleY = 1.0, const float translateX = 0.0, const float translateY = 0.0, const float theta = 0.0);
+
+    /// replace polygon i with a copy of a polygon
+    /// @param i index of the polygon to replace
+    /// @param polygon new polygon
+    void set(size_t i, const ConvexPolygon &polygon);
+
+    /// replace polygon i (moving the points of the polygons after it if the number of points changes)
+    /// @param i index of the polygon to replace
+    /// @param pts array of coordinate points (must form a convex polygon)
+    /// @param numPts number of points in pts
+    /// @param color color for polygon
+    /// @param scaleX x-scale factor
+    /// @param scaleY y-scale factor
+    /// @param translateX x-translate amount
+    /// @param translateY y-translate amount
+    /// @param theta - rotate Z amount in degrees
+    void set(size_t i, const Point3D *pts, size_t numPts, const Color &color, const float scaleX = 1.0, const float scaleY = 1.0, const float translateX = 0.0, const float translateY = 0.0, const float theta = 0.0);
+
+    /// change the transform of polygon i (e.g., to animate it) without touching its points
+    void setTransform(size_t i, const float scaleX, const float scaleY, const float translateX, const float translateY, const float theta);
+
+    /// reserve memory so adding polygons does not reallocate
+    /// @param numPolygons number of polygons
+    /// @param numPoints total number of points of all the polygons
+    void reserve(size_t numPolygons, size_t numPoints);
+
+    /// remove every polygon (keeping the memory for reuse)
+    void clear();
+
+    /// number of polygons
+    size_t size() const { return _colors.size(); }
+
+    /// total number of points of all the polygons
+    size_t numPoints() const { return _xs.size(); }
+
+    /// number of points of polygon i
+    size_t numPoints(size_t i) const { return _firstPoint[i + 1] - _firstPoint[i]; }
+
+    /// color of polygon i
+    const Color& color(size_t i) const { return _colors[i]; }
+
+    /// copy of polygon i as a ConvexPolygon
+    ConvexPolygon polygon(size_t i) const;
+
+    /// transform the points of every polygon that changed since the last call with its scale, rotate and translate
+    /// (gives the same results as ConvexPolygon::transformedPoints)
+    void transform();
+
+    /// true if transform() has been called since the last change
+    bool isTransformed() const { return _numTransformed == size() && _changed.empty(); }
+
+    /// transformed points of polygon i (only valid when isTransformed())
+    PointArrays transformedPoints(size_t i) const {
+        uint32_t first = _firstPoint[i];
+        return PointArrays(&_transformedXs[first], &_transformedYs[first], &_zs[first]);
+    }
+
+private:
+    // points of all polygons
+    std::vector<float> _xs, _ys, _zs;
+    // index of the first point of each polygon (the last element is the number of points)
+    std::vector<uint32_t> _firstPoint;
+    // index of the polygon of each point
+    std::vector<uint32_t> _pointPolygon;
+    // per polygon data
+    std::vector<Color> _colors;
+    std::vector<float> _scaleX, _scaleY;
+    std::vector<float> _translateX, _translateY;
+    std::vector<float> _theta;
+    // composed transform of each polygon: x' = a * x + b * y + c and y' = d * x + e * y + f
+    std::vector<float> _a, _b, _c, _d, _e, _f;
+    // transformed x and y of all points (z is unchanged so _zs is used)
+    std::vector<float> _transformedXs, _transformedYs;
+    // polygons before this have been transformed
+    size_t _numTransformed;
+    // polygons before _numTransformed whose transform changed
+    std::vector<size_t> _changed;
+
+    /// compose the transform of polygon i into _a to _f
+    void _composeTransform(size_t i);
+
+    /// transform the points in [first, last) with the transforms of their polygons
+    void _transformPoints(uint32_t first, uint32_t last);
+};
+
+#endif /* PolygonBatch_hpp */
@@ -0,0 +1,160 @@
+//
+//  SceneFile.cpp
+//  ComputerGraphics
+//
+//  Created by agent on 10/17/26.
+//  Copyright © 2026 agent. All rights reserved.
+//
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include "SceneFile.hpp"
+
+// the sections are used in place so they must have no padding
+static_assert(sizeof(SceneFileHeader) == 20, "SceneFileHeader must be packed");
+static_assert(sizeof(SceneFilePolygon) == 8 * sizeof(float), "SceneFilePolygon must be packed");
+static_assert(sizeof(SceneFileBoundingBox) == 4 * sizeof(float), "SceneFileBoundingBox must be packed");
+static_assert(sizeof(Point3D) == 3 * sizeof(float), "Point3D must be packed");
+
+const char SceneFileHeader::Magic[4] = {'C', 'P', 'S', 'B'};
+
+SceneFile::SceneFile(const std::string &filename) : _file(filename) {
+    _header = nullptr;
+    _firstPoint = nullptr;
+    _polygons = nullptr;
+    _points = nullptr;
+    _boxes = nullptr;
+
+    if (_file.size() < sizeof(SceneFileHeader) || memcmp(_file.data(), SceneFileHeader::Magic, sizeof(SceneFileHeader::Magic)) != 0) {
+        return;
+    }
+    _header = reinterpret_cast<const SceneFileHeader*>(_file.data());
+    if (_header->version != SceneFileHeader::CurrentVersion) {
+        _error = filename + ": unsupported scene file version " + std::to_string(_header->version);
+        return;
+    }
+
+    // use 64 bit sizes so huge counts in a corrupt header cannot overflow
+    uint64_t numPolygons = _header->numPolygons;
+    uint64_t numPoints = _header->numPoints;
+    bool hasBoxes = (_header->flags & SceneFileHeader::HasBoundingBoxes) != 0;
+    uint64_t firstPointOffset = sizeof(SceneFileHeader);
+    uint64_t polygonsOffset = firstPointOffset + (numPolygons + 1) * sizeof(uint32_t);
+    uint64_t pointsOffset = polygonsOffset + numPolygons * sizeof(SceneFilePolygon);
+    uint64_t boxesOffset = pointsOffset + numPoints * sizeof(Point3D);
+    uint64_t size = boxesOffset + (hasBoxes ? numPolygons * sizeof(SceneFileBoundingBox) : 0);
+    if (size > _file.size()) {
+        _error = filename + ": scene file is truncated";
+        return;
+    }
+
+    _firstPoint = reinterpret_cast<const uint32_t*>(_file.data() + firstPointOffset);
+    _polygons = reinterpret_cast<const SceneFilePolygon*>(_file.data() + polygonsOffset);
+    _points = reinterpret_cast<const Point3D*>(_file.data() + pointsOffset);
+    if (hasBoxes) {
+        _boxes = reinterpret_cast<const SceneFileBoundingBox*>(_file.data() + boxesOffset);
+    }
+
+    // check the offset table once so the accessors do not need to
+    if (_firstPoint[0] != 0 || _firstPoint[numPolygons] != numPoints) {
+        _error = filename + ": scene file has a bad offset table";
+        return;
+    }
+    for (uint64_t i=0; i<numPolygons; ++i) {
+        if (_firstPoint[i + 1] < _firstPoint[i]) {
+            _error = filename + ": scene file has a bad offset table";
+            return;
+        }
+    }
+}
+
+bool SceneFile::write(const std::string &filename, const std::vector<ConvexPolygon> &polygons, bool boundingBoxes) {
+    return write(filename, polygons.size(), [&](size_t i) -> const ConvexPolygon& { return polygons[i]; }, boundingBoxes);
+}
+
+bool SceneFile::write(const std::string &filename, size_t numPolygons, const std::function<const ConvexPolygon& (size_t i)> &polygon, bool boundingBoxes) {
+    if (numPolygons >= UINT32_MAX) {
+        return false;
+    }
+    if (!_write(filename, numPolygons, polygon, boundingBoxes)) {
+        // do not leave a truncated file behind that looks like a scene file
+        std::remove(filename.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool SceneFile::_write(const std::string &filename, size_t numPolygons, const std::function<const ConvexPolygon& (size_t i)> &polygon, bool boundingBoxes) {
+    std::ofstream outfile(filename.c_str(), std::ios::binary);
+    if (!outfile) {
+        return false;
+    }
+
+    // the header is written again once the number of points is known
+    SceneFileHeader header;
+    memcpy(header.magic, SceneFileHeader::Magic, sizeof(header.magic));
+    header.version = SceneFileHeader::CurrentVersion;
+    header.flags = boundingBoxes ? SceneFileHeader::HasBoundingBoxes : 0;
+    header.numPolygons = uint32_t(numPolygons);
+    header.numPoints = 0;
+    outfile.write((const char *) &header, sizeof(header));
+
+    // one pass over the polygons for each section so they never all need to be in memory at once
+    // offset table
+    uint64_t numPoints = 0;
+    for (size_t i=0; i<numPolygons; ++i) {
+        uint32_t firstPoint = uint32_t(numPoints);
+        outfile.write((const char *) &firstPoint, sizeof(firstPoint));
+        numPoints += polygon(i).points().size();
+        if (numPoints >= UINT32_MAX) {
+            return false;
+        }
+    }
+    header.numPoints = uint32_t(numPoints);
+    outfile.write((const char *) &header.numPoints, sizeof(header.numPoints));
+
+    // color and transform
+    for (size_t i=0; i<numPolygons; ++i) {
+        const ConvexPolygon &pg = polygon(i);
+        Color color = pg.color();
+        SceneFilePolygon p = { color.r, color.g, color.b, pg.scaleX(), pg.scaleY(), pg.translateX(), pg.translateY(), pg.theta() };
+        outfile.write((const char *) &p, sizeof(p));
+    }
+
+    // points
+    for (size_t i=0; i<numPolygons; ++i) {
+        const std::vector<Point3D> &pts = polygon(i).points();
+        outfile.write((const char *) pts.data(), pts.size() * sizeof(Point3D));
+    }
+
+    if (boundingBoxes) {
+        for (size_t i=0; i<numPolygons; ++i) {
+            SceneFileBoundingBox box = { 0.0f, 0.0f, 0.0f, 0.0f };
+            const std::vector<vec4> &pts = polygon(i).transformedPoints();
+            if (!pts.empty()) {
+                box.minX = box.maxX = pts[0].x;
+                box.minY = box.maxY = pts[0].y;
+                for (const vec4 &p: pts) {
+                    box.minX = std::min(box.minX, p.x);
+                    box.maxX = std::max(box.maxX, p.x);
+                    box.minY = std::min(box.minY, p.y);
+                    box.maxY = std::max(box.maxY, p.y);
+                }
+            }
+            outfile.write((const char *) &box, sizeof(box));
+        }
+    }
+
+    outfile.seekp(0);
+    outfile.write((const char *) &header, sizeof(header));
+    // closing writes what is still buffered, which can fail too
+    outfile.close();
+    return !outfile.fail();
+}
+
+void SceneFile::readPolygon(size_t i, ConvexPolygon &polygon) const {
+    const SceneFilePolygon &p = _polygons[i];
+    polygon.set(points(i), numPoints(i), Color(p.r, p.g, p.b), p.scaleX, p.scaleY, p.translateX, p.translateY, p.theta);
+}
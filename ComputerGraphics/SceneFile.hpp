@@ -0,0 +1,136 @@
+//
+//  SceneFile.hpp
+//  ComputerGraphics
+//
+//  Created by agent on 10/17/26.
+//  Copyright © 2026 agent. All rights reserved.
+//
+
+#ifndef SceneFile_hpp
+#define SceneFile_hpp
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "Point.hpp"
+#include "ConvexPolygon.hpp"
+#include "MappedFile.hpp"
+
+/// header at the start of a binary scene file
+/// the file is written in the byte order of the machine (little endian on every platform we build for)
+/// and every section is a multiple of 4 bytes so the arrays can be used straight from the mapped file:
+///   SceneFileHeader header
+///   uint32_t firstPoint[numPolygons + 1]      index of the first point of each polygon (the last is numPoints)
+///   SceneFilePolygon polygons[numPolygons]    color and transform of each polygon
+///   Point3D points[numPoints]                 x y z of the points of all the polygons
+///   SceneFileBoundingBox boxes[numPolygons]   only if flags has SceneFileHeader::HasBoundingBoxes
+struct SceneFileHeader {
+    /// first four bytes of every binary scene file
+    static const char Magic[4];
+    /// current version of the format
+    static const uint32_t CurrentVersion = 1;
+    /// flag set when the file has a bounding box for each polygon
+    static const uint32_t HasBoundingBoxes = 1;
+
+    char magic[4];
+    uint32_t version;
+    uint32_t flags;
+    uint32_t numPolygons;
+    uint32_t numPoints;
+};
+
+/// color and transform of one polygon in a binary scene file (same order as the text format)
+struct SceneFilePolygon {
+    float r, g, b;
+    float scaleX, scaleY;
+    float translateX, translateY;
+    float theta;
+};
+
+/// x and y extent of a polygon after it is transformed (i.e., in window coordinates)
+/// ConvexPolygonRasterizer::renderFile uses them to reject polygons outside the buffers without reading their points
+struct SceneFileBoundingBox {
+    float minX, minY;
+    float maxX, maxY;
+};
+
+/// read-only view of a memory mapped binary scene file
+/// the polygons can be read in any order without parsing the rest of the file
+class SceneFile {
+public:
+    /// map a binary scene file and check its header and size
+    /// @param filename file to open
+    SceneFile(const std::string &filename);
+
+    /// write polygons to a binary scene file
+    /// @param filename file to write
+    /// @param polygons polygons to write
+    /// @param boundingBoxes true to store the transformed bounding box of each polygon
+    /// @return false if the file could not be written (and then the file is removed rather than left partly written)
+    static bool write(const std::string &filename, const std::vector<ConvexPolygon> &polygons, bool boundingBoxes = true);
+
+    /// write polygons that are created as they are needed to a binary scene file (e.g., more than fit in memory)
+    /// polygon is called for i from 0 to numPolygons - 1 in order once for each section of the file
+    /// (three or four times) and must give the same polygon every time it is called for the same i
+    /// @param filename file to write
+    /// @param numPolygons number of polygons
+    /// @param polygon function returning polygon i (the reference only needs to be valid until the next call)
+    /// @param boundingBoxes true to store the transformed bounding box of each polygon
+    /// @return false if the file could not be written or has too many polygons or points for the format
+    /// (and then the file is removed rather than left partly written)
+    static bool write(const std::string &filename, size_t numPolygons, const std::function<const ConvexPolygon& (size_t i)> &polygon, bool boundingBoxes = true);
+
+    /// true if the file was opened and starts with SceneFileHeader::Magic (a text scene file does not)
+    bool isSceneFile() const { return _header != nullptr; }
+
+    /// true if the file is a binary scene file with an unsupported version or is too short for its header counts
+    bool failed() const { return !_error.empty(); }
+
+    /// description of why the file could not be used
+    const std::string& error() const { return _error; }
+
+    /// number of polygons in the file
+    size_t numPolygons() const { return isSceneFile() && !failed() ? _header->numPolygons : 0; }
+
+    /// total number of points of all the polygons in the file
+    size_t numPoints() const { return isSceneFile() && !failed() ? _header->numPoints : 0; }
+
+    /// number of points in polygon i
+    size_t numPoints(size_t i) const { return _firstPoint[i + 1] - _firstPoint[i]; }
+
+    /// points of polygon i (stored in the mapped file)
+    const Point3D* points(size_t i) const { return _points + _firstPoint[i]; }
+
+    /// color and transform of polygon i
+    const SceneFilePolygon& polygon(size_t i) const { return _polygons[i]; }
+
+    /// true if the file has a bounding box for each polygon
+    bool hasBoundingBoxes() const { return _boxes != nullptr; }
+
+    /// transformed bounding box of polygon i (only if hasBoundingBoxes())
+    const SceneFileBoundingBox& boundingBox(size_t i) const { return _boxes[i]; }
+
+    /// transformed bounding boxes of all the polygons in order (nullptr if the file has none)
+    const SceneFileBoundingBox* boundingBoxes() const { return _boxes; }
+
+    /// set polygon to polygon i of the file
+    /// @param i index of the polygon to read
+    /// @param polygon polygon to store the data in
+    void readPolygon(size_t i, ConvexPolygon &polygon) const;
+
+private:
+    /// write the file for write (which removes it if this fails)
+    static bool _write(const std::string &filename, size_t numPolygons, const std::function<const ConvexPolygon& (size_t i)> &polygon, bool boundingBoxes);
+
+    MappedFile _file;
+    const SceneFileHeader *_header;
+    const uint32_t *_firstPoint;
+    const SceneFilePolygon *_polygons;
+    const Point3D *_points;
+    const SceneFileBoundingBox *_boxes;
+    std::string _error;
+};
+
+#endif /* SceneFile_hpp */
@@ -0,0 +1,151 @@
+//
+//  SceneGenerator.cpp
+//  ComputerGraphics
+//
+//  Created by agent on 10/17/26.
+//  Copyright © 2026 agent. All rights reserved.
+//
+
+#include <algorithm>
+#include <cmath>
+
+#include "SceneGenerator.hpp"
+
+SceneGenerator::SceneGenerator(const Options &options) : _options(options), _engine(options.seed), _index(0) {
+    _options.minVertices = std::max(_options.minVertices, 3);
+    _options.maxVertices = std::max(_options.maxVertices, _options.minVertices);
+    _options.depthLayers = std::max(_options.depthLayers, 0);
+    _options.offScreenFraction = std::min(std::max(_options.offScreenFraction, 0.0f), 1.0f);
+
+    _radius = _options.radius;
+    size_t numOnScreen = size_t(_options.numPolygons * (1.0f - _options.offScreenFraction));
+    if (_options.overdraw > 0.0f && numOnScreen > 0) {
+        // a regular polygon with n points on a circle of radius r has area n/2 * r^2 * sin(2pi/n)
+        // so average that over the possible numbers of points and solve for r
+        double areaPerRadiusSquared = 0.0;
+        for (int n=_options.minVertices; n<=_options.maxVertices; ++n) {
+            areaPerRadiusSquared += 0.5 * n * sin(2.0 * M_PI / n);
+        }
+        areaPerRadiusSquared /= _options.maxVertices - _options.minVertices + 1;
+        // mean of the square of the radius divided by the square of the mean radius
+        if (_options.sizeDistribution == Uniform) {
+            areaPerRadiusSquared *= (1.5 * 1.5 * 1.5 - 0.5 * 0.5 * 0.5) / 3.0;
+        }
+        else if (_options.sizeDistribution == Exponential) {
+            areaPerRadiusSquared *= 2.0;
+        }
+        double totalArea = double(_options.overdraw) * _options.width * _options.height;
+        _radius = float(sqrt(totalArea / (numOnScreen * areaPerRadiusSquared)));
+    }
+}
+
+void SceneGenerator::next(ConvexPolygon &polygon) {
+    int numPts = _options.minVertices + int(_random() * (_options.maxVertices - _options.minVertices + 1));
+    numPts = std::min(numPts, _options.maxVertices);
+    float radius = _nextRadius();
+
+    // the polygon is a plane whose depth changes by at most slope over its radius in any direction
+    // (with layers the slope is small enough that polygons in different layers never overlap in depth)
+    float depthRange = _options.farZ - _options.nearZ;
+    float slope = 0.1f * depthRange / std::max(_options.depthLayers, 1);
+    float z0 = _options.nearZ + 1.5f * slope + _nextDepth() * (depthRange - 3.0f * slope);
+    float dzdx = _random(-slope, slope) / radius;
+    float dzdy = _random(-slope, slope) / radius;
+
+    // one point at a random angle in each of numPts equal slices of the circle keeps the points in order
+    // around the circle (so the polygon is convex) without any of them being too close together
+    _pts.resize(numPts);
+    float start = _random(0.0f, float(2.0 * M_PI));
+    float slice = float(2.0 * M_PI) / numPts;
+    float centerX = 0.0f, centerY = 0.0f;
+    for (int i=0; i<numPts; ++i) {
+        float angle = start + (i + _random()) * slice;
+        float x = radius * cosf(angle);
+        float y = radius * sinf(angle);
+        _pts[i].set(x, y, z0 + dzdx * x + dzdy * y);
+        centerX += x;
+        centerY += y;
+    }
+    // move the points so their center (which the polygon is rotated around) is at the origin
+    // so the polygon is centered at its translation and every point is within 2 * radius of it
+    centerX /= numPts;
+    centerY /= numPts;
+    for (Point3D &p: _pts) {
+        p.x -= centerX;
+        p.y -= centerY;
+    }
+
+    // separate statements so the random numbers are used in the same order with every compiler
+    Color color;
+    color.r = _random();
+    color.g = _random();
+    color.b = _random();
+    float theta = _random(0.0f, _options.maxRotation);
+
+    float translateX, translateY;
+    if (_random() < _options.offScreenFraction) {
+        // past a random edge of the window by more than the distance of any point from the center
+        float margin = radius * _random(2.01f, 3.0f);
+        float along = _random();
+        int edge = std::min(int(_random() * 4), 3);
+        translateX = edge == 0 ? -margin : edge == 1 ? _options.width + margin : along * _options.width;
+        translateY = edge == 2 ? -margin : edge == 3 ? _options.height + margin : along * _options.height;
+    }
+    else {
+        translateX = _random(0.0f, float(_options.width));
+        translateY = _random(0.0f, float(_options.height));
+    }
+    polygon.set(_pts.data(), _pts.size(), color, 1.0f, 1.0f, translateX, translateY, theta);
+    ++_index;
+}
+
+std::vector<ConvexPolygon> SceneGenerator::generate() {
+    std::vector<ConvexPolygon> polygons(_options.numPolygons);
+    for (ConvexPolygon &polygon: polygons) {
+        next(polygon);
+    }
+    return polygons;
+}
+
+void SceneGenerator::restart() {
+    _engine.seed(_options.seed);
+    _index = 0;
+}
+
+float SceneGenerator::_random() {
+    // the top 24 bits of the engine (which gives the same sequence everywhere) fit exactly in a float
+    return (_engine() >> 8) * (1.0f / 16777216.0f);
+}
+
+float SceneGenerator::_nextRadius() {
+    float u = _random();
+    switch (_options.sizeDistribution) {
+        case Uniform:
+            return _radius * (0.5f + u);
+        case Exponential:
+            // at least half a pixel so the depth slope stays finite
+            return std::max(-_radius * logf(1.0f - u), 0.5f);
+        default:
+            return _radius;
+    }
+}
+
+float SceneGenerator::_nextDepth() {
+    float u = _random();
+    float depth;
+    if (_options.depthOrder == RandomDepth || _options.numPolygons == 0) {
+        depth = u;
+    }
+    else {
+        // a random depth in this polygon's share of the range so the depths are in order
+        depth = std::min(float((_index + double(u)) / _options.numPolygons), 1.0f);
+        if (_options.depthOrder == BackToFront) {
+            depth = 1.0f - depth;
+        }
+    }
+    if (_options.depthLayers > 0) {
+        int layer = std::min(int(depth * _options.depthLayers), _options.depthLayers - 1);
+        depth = (layer + 0.5f) / _options.depthLayers;
+    }
+    return depth;
+}
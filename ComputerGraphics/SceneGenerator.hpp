@@ -0,0 +1,117 @@
+//
+//  SceneGenerator.hpp
+//  ComputerGraphics
+//
+//  Created by agent on 10/17/26.
+//  Copyright © 2026 agent. All rights reserved.
+//
+
+#ifndef SceneGenerator_hpp
+#define SceneGenerator_hpp
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "Point.hpp"
+#include "ConvexPolygon.hpp"
+
+/// creates random convex polygons for benchmarks and test scenes
+/// each polygon has its points on a circle and is rotated by a random angle around its center
+/// and translated to a random center in the window; its points lie on a plane so the depths are consistent across the polygon
+/// the same options (including the seed) always create the same polygons
+class SceneGenerator {
+public:
+    /// how the radii of the polygons are chosen (all have a mean of radius())
+    enum SizeDistribution {
+        /// every polygon has radius()
+        Fixed,
+        /// uniform between 0.5 and 1.5 times radius()
+        Uniform,
+        /// exponential (many small polygons and a few large ones)
+        Exponential
+    };
+
+    /// order of the depths of the polygons
+    enum DepthOrder {
+        /// random depths
+        RandomDepth,
+        /// the depth of each polygon's center is farther than the one before it (the fewest pixels are overdrawn)
+        FrontToBack,
+        /// the depth of each polygon's center is nearer than the one before it (nearly every pixel drawn passes the depth test)
+        BackToFront
+    };
+
+    /// settings for the polygons created
+    struct Options {
+        /// number of polygons generate() creates (also used by overdraw and the depth orders)
+        size_t numPolygons = 1000;
+        /// fewest points of a polygon (at least 3)
+        int minVertices = 3;
+        /// most points of a polygon
+        int maxVertices = 8;
+        /// mean radius of the circle the points of a polygon are on
+        float radius = 20.0f;
+        /// if greater than 0, the radius is chosen so the polygons cover about this many times the window area
+        float overdraw = 0.0f;
+        /// how the radius of each polygon is chosen
+        SizeDistribution sizeDistribution = Fixed;
+        /// order of the depths of the polygons
+        DepthOrder depthOrder = RandomDepth;
+        /// if greater than 0, the polygons are on this many separate depths that do not overlap
+        int depthLayers = 0;
+        /// polygons are rotated by a random angle in [0, maxRotation) degrees
+        float maxRotation = 360.0f;
+        /// fraction of the polygons that are entirely outside the window
+        float offScreenFraction = 0.0f;
+        /// width and height of the window
+        int width = 960, height = 540;
+        /// depths are in [nearZ, farZ]
+        float nearZ = 0.0f, farZ = 1.0f;
+        /// seed for the random numbers
+        uint32_t seed = 1;
+    };
+
+    /// constructor
+    /// @param options settings for the polygons created
+    SceneGenerator(const Options &options);
+
+    /// create the next random polygon
+    /// reuses the storage polygon already has so creating many polygons into the same one does not allocate memory
+    /// @param polygon polygon to store the data in
+    void next(ConvexPolygon &polygon);
+
+    /// create options().numPolygons random polygons
+    std::vector<ConvexPolygon> generate();
+
+    /// start over so next creates the same polygons again
+    void restart();
+
+    /// settings for the polygons created
+    const Options& options() const { return _options; }
+
+    /// mean radius of the circle the points of each polygon are on (from options.radius or options.overdraw)
+    float radius() const { return _radius; }
+
+private:
+    /// random float in [0, 1) that is the same on every platform (unlike std::uniform_real_distribution)
+    float _random();
+
+    /// random float in [minValue, maxValue)
+    float _random(float minValue, float maxValue) { return minValue + (maxValue - minValue) * _random(); }
+
+    /// radius of the next polygon
+    float _nextRadius();
+
+    /// depth of the center of the next polygon between 0 (nearZ) and 1 (farZ)
+    float _nextDepth();
+
+    Options _options;
+    float _radius;
+    std::mt19937 _engine;
+    // number of polygons created since the start
+    size_t _index;
+    std::vector<Point3D> _pts;
+};
+
+#endif /* SceneGenerator_hpp */
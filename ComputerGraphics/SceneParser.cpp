@@ -0,0 +1,230 @@
+//
+//  SceneParser.cpp
+//  ComputerGraphics
+//
+//  Created by agent on 10/17/26.
+//  Copyright © 2026 agent. All rights reserved.
+//
+
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include "SceneParser.hpp"
+
+// powers of ten that are exactly representable as a double
+static const double exactPowersOfTen[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static inline bool isWhitespace(char c) {
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\f' || c == '\v';
+}
+
+static inline bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+/// parse a decimal number in [start, end) where end is the end of the token
+/// @return false if the token is not a number
+static bool parseNumber(const char *start, const char *end, double &value) {
+    const char *p = start;
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        ++p;
+    }
+
+    // up to 19 significant digits fit in 64 bits
+    uint64_t mantissa = 0;
+    int numDigits = 0;
+    int significantDigits = 0;
+    int exponent = 0;
+    for (; p < end && isDigit(*p); ++p, ++numDigits) {
+        if (significantDigits < 19) {
+            mantissa = mantissa * 10 + (*p - '0');
+            significantDigits += mantissa != 0;
+        }
+        else {
+            ++exponent;
+        }
+    }
+    if (p < end && *p == '.') {
+        for (++p; p < end && isDigit(*p); ++p, ++numDigits) {
+            if (significantDigits < 19) {
+                mantissa = mantissa * 10 + (*p - '0');
+                significantDigits += mantissa != 0;
+                --exponent;
+            }
+        }
+    }
+    if (numDigits == 0) {
+        return false;
+    }
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        ++p;
+        bool negativeExponent = false;
+        if (p < end && (*p == '-' || *p == '+')) {
+            negativeExponent = *p == '-';
+            ++p;
+        }
+        if (p == end || !isDigit(*p)) {
+            return false;
+        }
+        int e = 0;
+        for (; p < end && isDigit(*p); ++p) {
+            if (e < 100000) {
+                e = e * 10 + (*p - '0');
+            }
+        }
+        exponent += negativeExponent ? -e : e;
+    }
+    if (p != end) {
+        return false;
+    }
+
+    // when the mantissa and power of ten are both exact doubles, one multiply or divide is correctly rounded
+    if (mantissa < (uint64_t(1) << 53) && exponent >= -22 && exponent <= 22) {
+        value = double(mantissa);
+        value = exponent < 0 ? value / exactPowersOfTen[-exponent] : value * exactPowersOfTen[exponent];
+    }
+    else {
+        // rare case so let the C library handle it
+        char token[64];
+        size_t length = size_t(end - start);
+        if (length >= sizeof(token)) {
+            return false;
+        }
+        memcpy(token, start, length);
+        token[length] = '\0';
+        value = strtod(token, nullptr);
+        return true;
+    }
+    if (negative) {
+        value = -value;
+    }
+    return true;
+}
+
+SceneParser::SceneParser(const std::string &filename) : _file(filename) {
+    _filename = filename;
+    _pos = _file.data();
+    _end = _pos + _file.size();
+    _line = 1;
+}
+
+bool SceneParser::readPolygon(ConvexPolygon &polygon) {
+    if (!_readPolygon()) {
+        return false;
+    }
+    polygon.set(_pts, _color, _scaleX, _scaleY, _translateX, _translateY, _theta);
+    return true;
+}
+
+bool SceneParser::readPolygon(PolygonBatch &batch) {
+    if (!_readPolygon()) {
+        return false;
+    }
+    batch.add(_pts.data(), _pts.size(), _color, _scaleX, _scaleY, _translateX, _translateY, _theta);
+    return true;
+}
+
+bool SceneParser::_readPolygon() {
+    if (failed() || !_skipWhitespace()) {
+        return false;
+    }
+
+    // read number of points
+    const char *countStart = _pos;
+    int numPts = 0;
+    if (!_readInt(numPts, "number of points")) {
+        return false;
+    }
+    if (numPts < 1) {
+        _pos = countStart;
+        return _fail("positive number of points");
+    }
+    // each point is at least three one character numbers each followed by whitespace
+    // so a corrupt count is reported here instead of trying to allocate memory for it
+    if (size_t(numPts) > size_t(_end - _pos) / 6) {
+        _pos = countStart;
+        return _fail("number of points that fits in the rest of the file");
+    }
+    // read each point (reusing the same vector for every polygon)
+    _pts.resize(numPts);
+    for (int i=0; i<numPts; ++i) {
+        if (!_readFloat(_pts[i].x, "point x") || !_readFloat(_pts[i].y, "point y") || !_readFloat(_pts[i].z, "point z")) {
+            return false;
+        }
+    }
+
+    // read color, scale, translate, and rotate
+    float r, g, b;
+    if (!_readFloat(r, "red") || !_readFloat(g, "green") || !_readFloat(b, "blue") ||
+        !_readFloat(_scaleX, "x-scale") || !_readFloat(_scaleY, "y-scale") ||
+        !_readFloat(_translateX, "x-translate") || !_readFloat(_translateY, "y-translate") ||
+        !_readFloat(_theta, "rotate angle")) {
+        return false;
+    }
+    _color = Color(r, g, b);
+    return true;
+}
+
+bool SceneParser::_skipWhitespace() {
+    while (_pos < _end && isWhitespace(*_pos)) {
+        if (*_pos == '\n') {
+            ++_line;
+        }
+        ++_pos;
+    }
+    return _pos < _end;
+}
+
+bool SceneParser::_readInt(int &value, const char *description) {
+    if (!_skipWhitespace()) {
+        return _fail(description);
+    }
+    const char *start = _pos;
+    float number;
+    if (!_readFloat(number, description)) {
+        return false;
+    }
+    // converting a float outside the range of int is undefined so check the range first (NAN fails both tests)
+    if (!(double(number) >= double(INT_MIN) && double(number) <= double(INT_MAX)) || number != float(int(number))) {
+        _pos = start;
+        return _fail(description);
+    }
+    value = int(number);
+    return true;
+}
+
+bool SceneParser::_readFloat(float &value, const char *description) {
+    if (!_skipWhitespace()) {
+        return _fail(description);
+    }
+    const char *start = _pos;
+    while (_pos < _end && !isWhitespace(*_pos)) {
+        ++_pos;
+    }
+    double number;
+    if (!parseNumber(start, _pos, number)) {
+        _pos = start;
+        return _fail(description);
+    }
+    value = float(number);
+    return true;
+}
+
+bool SceneParser::_fail(const char *description) {
+    std::string found = "end of file";
+    if (_pos < _end) {
+        const char *tokenEnd = _pos;
+        while (tokenEnd < _end && !isWhitespace(*tokenEnd)) {
+            ++tokenEnd;
+        }
+        found = "\"" + std::string(_pos, tokenEnd) + "\"";
+    }
+    _error = _filename + ":" + std::to_string(_line) + ": expected " + description + " but found " + found;
+    return false;
+}
@@ -0,0 +1,72 @@
+//
+//  SceneParser.hpp
+//  ComputerGraphics
+//
+//  Created by agent on 10/17/26.
+//  Copyright © 2026 agent. All rights reserved.
+//
+
+#ifndef SceneParser_hpp
+#define SceneParser_hpp
+
+#include <string>
+#include <vector>
+
+#include "Point.hpp"
+#include "ConvexPolygon.hpp"
+#include "PolygonBatch.hpp"
+#include "MappedFile.hpp"
+
+/// reads ConvexPolygon objects one at a time from a memory mapped text file
+/// in the same format as operator>> for ConvexPolygon:
+/// number of points, x y z for each point, r g b, scaleX scaleY, translateX translateY, theta
+class SceneParser {
+public:
+    /// open file for parsing
+    /// @param filename file containing the polygons
+    SceneParser(const std::string &filename);
+
+    /// true if the file could be opened
+    bool isOpen() const { return _file.isOpen(); }
+
+    /// read the next polygon from the file
+    /// reuses the storage polygon already has so reading into the same polygon does not allocate memory
+    /// @param polygon polygon to store the data in
+    /// @return false at end of file or if the input is malformed (check failed())
+    bool readPolygon(ConvexPolygon &polygon);
+
+    /// read the next polygon from the file and add it to the end of batch
+    /// (the batch arrays grow by doubling so reading many polygons only allocates memory a few times)
+    /// @param batch batch to add the polygon to
+    /// @return false at end of file or if the input is malformed (check failed())
+    bool readPolygon(PolygonBatch &batch);
+
+    /// true if malformed input was found
+    bool failed() const { return !_error.empty(); }
+
+    /// description of the malformed input including the file name and line number
+    const std::string& error() const { return _error; }
+
+private:
+    /// read the next polygon into _pts, _color, and the transform members
+    bool _readPolygon();
+    bool _skipWhitespace();
+    bool _readInt(int &value, const char *description);
+    bool _readFloat(float &value, const char *description);
+    bool _fail(const char *description);
+
+    MappedFile _file;
+    std::string _filename;
+    const char *_pos;
+    const char *_end;
+    int _line;
+    std::string _error;
+    // the polygon read by _readPolygon
+    std::vector<Point3D> _pts;
+    Color _color;
+    float _scaleX, _scaleY;
+    float _translateX, _translateY;
+    float _theta;
+};
+
+#endif /* SceneParser_hpp */
@@ -0,0 +1,333 @@
+//
+//  SpanFill.cpp
+//  ComputerGraphics
+//
+//  Created by agent on 10/17/26.
+//  Copyright © 2026 agent. All rights reserved.
+//
+
+#include <bitset>
+#include <cmath>
+#include "SpanFill.hpp"
+
+#ifdef SPAN_FILL_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+// MSVC allows any intrinsic in any function
+#define TARGET_AVX2
+#else
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+// the colors are stored with masked float stores
+static_assert(sizeof(Color) == 3 * sizeof(float), "Color must be three packed floats");
+
+// depth test columns firstX through lastX one at a time (storing id for each pixel that passes if idRow is not nullptr)
+static inline size_t spanFillPixels(float *depthRow, Color *colorRow, int spanX, int firstX, int lastX, float z, float dz, const Color &color, uint32_t *idRow = nullptr, uint32_t id = 0) {
+    size_t numVisible = 0;
+    for (int x = firstX; x <= lastX; ++x) {
+        // compute each depth from the start of the span (rather than adding dz) so all versions
+        // and any part of a span (such as the part in one tile) give identical results
+        float depth = z + float(x - spanX) * dz;
+        if (depthRow[x] > depth) {
+            depthRow[x] = depth;
+            colorRow[x] = color;
+            if (idRow != nullptr) {
+                idRow[x] = id;
+            }
+            ++numVisible;
+        }
+    }
+    return numVisible;
+}
+
+size_t spanFillScalar(float *depthRow, Color *colorRow, int spanX, int firstX, int lastX, float z, float dz, const Color &color) {
+    return spanFillPixels(depthRow, colorRow, spanX, firstX, lastX, z, dz, color);
+}
+
+#ifdef SPAN_FILL_X86
+
+// depth test four pixels at a time with SSE2 (storing id for each pixel that passes if idRow is not nullptr)
+static inline size_t spanFillPixelsSSE2(float *depthRow, Color *colorRow, int spanX, int firstX, int lastX, float z, float dz, const Color &color, uint32_t *idRow = nullptr, uint32_t id = 0) {
+    size_t numVisible = 0;
+    const __m128 lanes = _mm_set_ps(3, 2, 1, 0);
+    const __m128 zStart = _mm_set1_ps(z);
+    const __m128 dzLanes = _mm_set1_ps(dz);
+
+    int x = firstX;
+    for (; x + 3 <= lastX; x += 4) {
+        __m128 depth = _mm_add_ps(zStart, _mm_mul_ps(_mm_add_ps(_mm_set1_ps(float(x - spanX)), lanes), dzLanes));
+        __m128 old = _mm_loadu_ps(depthRow + x);
+        __m128 closer = _mm_cmplt_ps(depth, old);
+        int bits = _mm_movemask_ps(closer);
+        if (bits == 0) {
+            continue;
+        }
+        // SSE2 has no blend so select with and/andnot/or
+        _mm_storeu_ps(depthRow + x, _mm_or_ps(_mm_and_ps(closer, depth), _mm_andnot_ps(closer, old)));
+        if (idRow != nullptr) {
+            __m128i closerIDs = _mm_castps_si128(closer);
+            __m128i oldIDs = _mm_loadu_si128((const __m128i *) (idRow + x));
+            __m128i newIDs = _mm_or_si128(_mm_and_si128(closerIDs, _mm_set1_epi32(int(id))), _mm_andnot_si128(closerIDs, oldIDs));
+            _mm_storeu_si128((__m128i *) (idRow + x), newIDs);
+        }
+        for (int j = 0; j < 4; ++j) {
+            if (bits & (1 << j)) {
+                colorRow[x + j] = color;
+            }
+        }
+        numVisible += std::bitset<4>(bits).count();
+    }
+    // finish any pixels that do not fill a whole register
+    return numVisible + spanFillPixels(depthRow, colorRow, spanX, x, lastX, z, dz, color, idRow, id);
+}
+
+size_t spanFillSSE2(float *depthRow, Color *colorRow, int spanX, int firstX, int lastX, float z, float dz, const Color &color) {
+    return spanFillPixelsSSE2(depthRow, colorRow, spanX, firstX, lastX, z, dz, color);
+}
+
+/// stores a color in the pixels of eight consecutive colors whose lanes of a mask are set using AVX2
+class ColorStoreAVX2 {
+public:
+    TARGET_AVX2 ColorStoreAVX2(const Color &color) {
+        // eight colors are 24 floats (three registers) of repeating r, g, b
+        _colors0 = _mm256_setr_ps(color.r, color.g, color.b, color.r, color.g, color.b, color.r, color.g);
+        _colors1 = _mm256_setr_ps(color.b, color.r, color.g, color.b, color.r, color.g, color.b, color.r);
+        _colors2 = _mm256_setr_ps(color.g, color.b, color.r, color.g, color.b, color.r, color.g, color.b);
+        // which pixel's depth test result each of those 24 floats uses
+        _pixels0 = _mm256_setr_epi32(0, 0, 0, 1, 1, 1, 2, 2);
+        _pixels1 = _mm256_setr_epi32(2, 3, 3, 3, 4, 4, 4, 5);
+        _pixels2 = _mm256_setr_epi32(5, 5, 6, 6, 6, 7, 7, 7);
+    }
+
+    TARGET_AVX2 void store(Color *colors, __m256i mask) const {
+        float *colorFloats = &colors->r;
+        _mm256_maskstore_ps(colorFloats, _mm256_permutevar8x32_epi32(mask, _pixels0), _colors0);
+        _mm256_maskstore_ps(colorFloats + 8, _mm256_permutevar8x32_epi32(mask, _pixels1), _colors1);
+        _mm256_maskstore_ps(colorFloats + 16, _mm256_permutevar8x32_epi32(mask, _pixels2), _colors2);
+    }
+
+private:
+    __m256 _colors0, _colors1, _colors2;
+    __m256i _pixels0, _pixels1, _pixels2;
+};
+
+// depth test eight pixels at a time with AVX2 (storing id for each pixel that passes if idRow is not nullptr)
+static TARGET_AVX2 inline size_t spanFillPixelsAVX2(float *depthRow, Color *colorRow, int spanX, int firstX, int lastX, float z, float dz, const Color &color, uint32_t *idRow = nullptr, uint32_t id = 0) {
+    size_t numVisible = 0;
+    const __m256 lanes = _mm256_set_ps(7, 6, 5, 4, 3, 2, 1, 0);
+    const __m256 zStart = _mm256_set1_ps(z);
+    const __m256 dzLanes = _mm256_set1_ps(dz);
+    const __m256i ids = _mm256_set1_epi32(int(id));
+    const ColorStoreAVX2 colors(color);
+
+    int x = firstX;
+    for (; x + 7 <= lastX; x += 8) {
+        __m256 depth = _mm256_add_ps(zStart, _mm256_mul_ps(_mm256_add_ps(_mm256_set1_ps(float(x - spanX)), lanes), dzLanes));
+        __m256 closer = _mm256_cmp_ps(depth, _mm256_loadu_ps(depthRow + x), _CMP_LT_OQ);
+        int bits = _mm256_movemask_ps(closer);
+        if (bits == 0) {
+            continue;
+        }
+        __m256i mask = _mm256_castps_si256(closer);
+        _mm256_maskstore_ps(depthRow + x, mask, depth);
+        colors.store(colorRow + x, mask);
+        if (idRow != nullptr) {
+            _mm256_maskstore_epi32((int *) (idRow + x), mask, ids);
+        }
+        numVisible += std::bitset<8>(bits).count();
+    }
+    // finish any pixels that do not fill a whole register
+    return numVisible + spanFillPixels(depthRow, colorRow, spanX, x, lastX, z, dz, color, idRow, id);
+}
+
+TARGET_AVX2 size_t spanFillAVX2(float *depthRow, Color *colorRow, int spanX, int firstX, int lastX, float z, float dz, const Color &color) {
+    return spanFillPixelsAVX2(depthRow, colorRow, spanX, firstX, lastX, z, dz, color);
+}
+
+// eight integer depths for depths z + (x - spanX + lane) * dz, rounded the same way as DepthMapping::quantize
+static TARGET_AVX2 inline __m256i quantizeDepthsAVX2(int x, int spanX, float z, float dz, const DepthMapping &mapping) {
+    const __m256 lanes = _mm256_set_ps(7, 6, 5, 4, 3, 2, 1, 0);
+    __m256 depth = _mm256_add_ps(_mm256_set1_ps(z), _mm256_mul_ps(_mm256_add_ps(_mm256_set1_ps(float(x - spanX)), lanes), _mm256_set1_ps(dz)));
+    __m256 t = _mm256_mul_ps(_mm256_sub_ps(depth, _mm256_set1_ps(mapping.nearZ)), _mm256_set1_ps(mapping.scale));
+    t = _mm256_max_ps(t, _mm256_setzero_ps());
+    t = _mm256_min_ps(t, _mm256_set1_ps(float(mapping.maxValue - 1)));
+    return _mm256_cvttps_epi32(_mm256_add_ps(t, _mm256_set1_ps(0.5f)));
+}
+
+TARGET_AVX2 size_t spanFillUInt16AVX2(uint16_t *depthRow, Color *colorRow, int spanX, int firstX, int lastX, float z, float dz, const DepthMapping &mapping, const Color &color) {
+    size_t numVisible = 0;
+    const ColorStoreAVX2 colors(color);
+
+    int x = firstX;
+    for (; x + 7 <= lastX; x += 8) {
+        __m256i depth = quantizeDepthsAVX2(x, spanX, z, dz, mapping);
+        // widen the eight 16 bit depths to 32 bits so they can be compared (they all fit in a signed int)
+        __m256i old = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *) (depthRow + x)));
+        __m256i closer = _mm256_cmpgt_epi32(old, depth);
+        int bits = _mm256_movemask_ps(_mm256_castsi256_ps(closer));
+        if (bits == 0) {
+            continue;
+        }
+        // narrow back to 16 bits (packus works on each 128 bit half so move the two results together)
+        __m256i merged = _mm256_blendv_epi8(old, depth, closer);
+        __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi32(merged, merged), 0x08);
+        _mm_storeu_si128((__m128i *) (depthRow + x), _mm256_castsi256_si128(packed));
+        colors.store(colorRow + x, closer);
+        numVisible += std::bitset<8>(bits).count();
+    }
+    // finish any pixels that do not fill a whole register
+    return numVisible + spanFillUInt16Scalar(depthRow, colorRow, spanX, x, lastX, z, dz, mapping, color);
+}
+
+TARGET_AVX2 size_t spanFillUInt24AVX2(uint32_t *depthRow, Color *colorRow, int spanX, int firstX, int lastX, float z, float dz, const DepthMapping &mapping, const Color &color) {
+    size_t numVisible = 0;
+    const ColorStoreAVX2 colors(color);
+
+    int x = firstX;
+    for (; x + 7 <= lastX; x += 8) {
+        __m256i depth = quantizeDepthsAVX2(x, spanX, z, dz, mapping);
+        // 24 bit depths fit in a signed int so the signed compare works
+        __m256i closer = _mm256_cmpgt_epi32(_mm256_loadu_si256((const __m256i *) (depthRow + x)), depth);
+        int bits = _mm256_movemask_ps(_mm256_castsi256_ps(closer));
+        if (bits == 0) {
+            continue;
+        }
+        _mm256_maskstore_epi32((int *) (depthRow + x), closer, depth);
+        colors.store(colorRow + x, closer);
+        numVisible += std::bitset<8>(bits).count();
+    }
+    // finish any pixels that do not fill a whole register
+    return numVisible + spanFillUInt32Scalar(depthRow, colorRow, spanX, x, lastX, z, dz, mapping, color);
+}
+
+static bool cpuSupportsAVX2() {
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    // the OS must also save the AVX registers on a context switch
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 6) != 6) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif
+
+SpanFillFunction bestSpanFillFunction() {
+#ifdef SPAN_FILL_X86
+    if (cpuSupportsAVX2()) {
+        return spanFillAVX2;
+    }
+    return spanFillSSE2;
+#else
+    return spanFillScalar;
+#endif
+}
+
+// MARK: integer depth
+
+DepthMapping::DepthMapping(int bits, float nearZ, float farZ) {
+    this->bits = bits;
+    this->nearZ = nearZ;
+    this->farZ = farZ;
+    maxValue = bits >= 32 ? 0xffffffffu : (1u << bits) - 1;
+    scaleDouble = farZ > nearZ ? double(maxValue - 1) / (double(farZ) - nearZ) : 0.0;
+    scale = float(scaleDouble);
+}
+
+float DepthMapping::dequantize(uint32_t value) const {
+    if (value == maxValue) {
+        return INFINITY;
+    }
+    return scaleDouble > 0.0 ? float(nearZ + value / scaleDouble) : nearZ;
+}
+
+// depth test columns firstX through lastX one at a time against integer depths (storing ids like spanFillPixels)
+template <typename T>
+static inline size_t spanFillIntegerPixels(T *depthRow, Color *colorRow, int spanX, int firstX, int lastX, float z, float dz, const DepthMapping &mapping, const Color &color, uint32_t *idRow = nullptr, uint32_t id = 0) {
+    size_t numVisible = 0;
+    for (int x = firstX; x <= lastX; ++x) {
+        uint32_t depth = mapping.quantize(z + float(x - spanX) * dz);
+        if (depthRow[x] > depth) {
+            depthRow[x] = T(depth);
+            colorRow[x] = color;
+            if (idRow != nullptr) {
+                idRow[x] = id;
+            }
+            ++numVisible;
+        }
+    }
+    return numVisible;
+}
+
+size_t spanFillUInt16Scalar(uint16_t *depthRow, Color *colorRow, int spanX, int firstX, int lastX, float z, float dz, const DepthMapping &mapping, const Color &color) {
+    return spanFillIntegerPixels(depthRow, colorRow, spanX, firstX, lastX, z, dz, mapping, color);
+}
+
+size_t spanFillUInt32Scalar(uint32_t *depthRow, Color *colorRow, int spanX, int firstX, int lastX, float z, float dz, const DepthMapping &mapping, const Color &color) {
+    return spanFillIntegerPixels(depthRow, colorRow, spanX, firstX, lastX, z, dz, mapping, color);
+}
+
+SpanFillUInt16Function bestSpanFillUInt16Function() {
+#ifdef SPAN_FILL_X86
+    if (cpuSupportsAVX2()) {
+        return spanFillUInt16AVX2;
+    }
+#endif
+    return spanFillUInt16Scalar;
+}
+
+SpanFillUInt32Function bestSpanFillUInt32Function(int bits) {
+#ifdef SPAN_FILL_X86
+    if (bits <= 24 && cpuSupportsAVX2()) {
+        return spanFillUInt24AVX2;
+    }
+#endif
+    return spanFillUInt32Scalar;
+}
+
+size_t spanFillIDsScalar(float *depthRow, Color *colorRow, uint32_t *idRow, int spanX, int firstX, int lastX, float z, float dz, const Color &color, uint32_t id) {
+    return spanFillPixels(depthRow, colorRow, spanX, firstX, lastX, z, dz, color, idRow, id);
+}
+
+#ifdef SPAN_FILL_X86
+size_t spanFillIDsSSE2(float *depthRow, Color *colorRow, uint32_t *idRow, int spanX, int firstX, int lastX, float z, float dz, const Color &color, uint32_t id) {
+    return spanFillPixelsSSE2(depthRow, colorRow, spanX, firstX, lastX, z, dz, color, idRow, id);
+}
+
+TARGET_AVX2 size_t spanFillIDsAVX2(float *depthRow, Color *colorRow, uint32_t *idRow, int spanX, int firstX, int lastX, float z, float dz, const Color &color, uint32_t id) {
+    return spanFillPixelsAVX2(depthRow, colorRow, spanX, firstX, lastX, z, dz, color, idRow, id);
+}
+#endif
+
+SpanFillIDsFunction bestSpanFillIDsFunction() {
+#ifdef SPAN_FILL_X86
+    if (cpuSupportsAVX2()) {
+        return spanFillIDsAVX2;
+    }
+    return spanFillIDsSSE2;
+#else
+    return spanFillIDsScalar;
+#endif
+}
+
+size_t spanFillUInt16IDsScalar(uint16_t *depthRow, Color *colorRow, uint32_t *idRow, int spanX, int firstX, int lastX, float z, float dz, const DepthMapping &mapping, const Color &color, uint32_t id) {
+    return spanFillIntegerPixels(depthRow, colorRow, spanX, firstX, lastX, z, dz, mapping, color, idRow, id);
+}
+
+size_t spanFillUInt32IDsScalar(uint32_t *depthRow, Color *colorRow, uint32_t *idRow, int spanX, int firstX, int lastX, float z, float dz, const DepthMapping &mapping, const Color &color, uint32_t id) {
+    return spanFillIntegerPixels(depthRow, colorRow, spanX, firstX, lastX, z, dz, mapping, color, idRow, id);
+}
@@ -0,0 +1,132 @@
+//
+//  SpanFill.hpp
+//  ComputerGraphics
+//
+//  Created by agent on 10/17/26.
+//  Copyright © 2026 agent. All rights reserved.
+//
+
+#ifndef SpanFill_hpp
+#define SpanFill_hpp
+
+#include <cstddef>
+#include <cstdint>
+
+#include "Color.hpp"
+
+/// depth test columns firstX through lastX (inclusive) of a span starting at column spanX where column x has depth z + (x - spanX) * dz
+/// depthRow and colorRow point to column 0 of the row; each pixel closer than depthRow[x] has its depth stored in depthRow[x] and color stored in colorRow[x]
+/// @return number of pixels that passed the depth test
+typedef size_t (*SpanFillFunction)(float *depthRow, Color *colorRow, int spanX, int firstX, int lastX, float z, float dz, const Color &color);
+
+/// one pixel at a time version (works on any CPU)
+size_t spanFillScalar(float *depthRow, Color *colorRow, int spanX, int firstX, int lastX, float z, float dz, const Color &color);
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define SPAN_FILL_X86
+
+/// four pixels at a time using SSE2 (always available on x86-64)
+size_t spanFillSSE2(float *depthRow, Color *colorRow, int spanX, int firstX, int lastX, float z, float dz, const Color &color);
+
+/// eight pixels at a time using AVX2 (only call if the CPU supports it)
+size_t spanFillAVX2(float *depthRow, Color *colorRow, int spanX, int firstX, int lastX, float z, float dz, const Color &color);
+#endif
+
+/// returns fastest span fill function supported by the CPU the program is running on
+SpanFillFunction bestSpanFillFunction();
+
+// MARK: integer depth
+
+/// maps depths from nearZ to farZ onto unsigned integers 0 to maxValue - 1 (rounded to nearest)
+/// depths outside the range are clamped to it and maxValue is the cleared (farthest) value
+/// so anything drawn passes the depth test against a cleared pixel
+class DepthMapping {
+public:
+    /// @param bits number of bits in the integer depths (16, 24, or 32)
+    /// @param nearZ depth mapped to 0
+    /// @param farZ depth mapped to maxValue - 1
+    DepthMapping(int bits = 16, float nearZ = 0.0f, float farZ = 1.0f);
+
+    /// integer depth for depth
+    /// 16 and 24 bits are computed with floats (like the SIMD versions), 32 bits with doubles since floats only have 24 bits
+    uint32_t quantize(float depth) const;
+
+    /// depth an integer depth represents (INFINITY for maxValue)
+    float dequantize(uint32_t value) const;
+
+    // public data for convenience
+    int bits;
+    float nearZ, farZ;
+    uint32_t maxValue;
+    float scale;
+    double scaleDouble;
+};
+
+inline uint32_t DepthMapping::quantize(float depth) const {
+    if (bits >= 32) {
+        double t = (double(depth) - nearZ) * scaleDouble;
+        t = t > 0.0 ? t : 0.0;
+        t = t < double(maxValue - 1) ? t : double(maxValue - 1);
+        return uint32_t(t + 0.5);
+    }
+    // written to round exactly the same as the max, min, and truncate of the SIMD versions
+    float t = (depth - nearZ) * scale;
+    t = t > 0.0f ? t : 0.0f;
+    t = t < float(maxValue - 1) ? t : float(maxValue - 1);
+    return uint32_t(t + 0.5f);
+}
+
+/// same as SpanFillFunction for 16 bit integer depths mapped by mapping
+typedef size_t (*SpanFillUInt16Function)(uint16_t *depthRow, Color *colorRow, int spanX, int firstX, int lastX, float z, float dz, const DepthMapping &mapping, const Color &color);
+
+/// same as SpanFillFunction for 24 or 32 bit integer depths (stored in 32 bits) mapped by mapping
+typedef size_t (*SpanFillUInt32Function)(uint32_t *depthRow, Color *colorRow, int spanX, int firstX, int lastX, float z, float dz, const DepthMapping &mapping, const Color &color);
+
+/// one pixel at a time version for 16 bit depths
+size_t spanFillUInt16Scalar(uint16_t *depthRow, Color *colorRow, int spanX, int firstX, int lastX, float z, float dz, const DepthMapping &mapping, const Color &color);
+
+/// one pixel at a time version for 24 or 32 bit depths
+size_t spanFillUInt32Scalar(uint32_t *depthRow, Color *colorRow, int spanX, int firstX, int lastX, float z, float dz, const DepthMapping &mapping, const Color &color);
+
+#ifdef SPAN_FILL_X86
+/// eight pixels at a time version for 16 bit depths using AVX2 (only call if the CPU supports it)
+size_t spanFillUInt16AVX2(uint16_t *depthRow, Color *colorRow, int spanX, int firstX, int lastX, float z, float dz, const DepthMapping &mapping, const Color &color);
+
+/// eight pixels at a time version for 24 bit depths using AVX2 (only call if the CPU supports it)
+size_t spanFillUInt24AVX2(uint32_t *depthRow, Color *colorRow, int spanX, int firstX, int lastX, float z, float dz, const DepthMapping &mapping, const Color &color);
+#endif
+
+/// returns fastest 16 bit depth span fill function supported by the CPU the program is running on
+SpanFillUInt16Function bestSpanFillUInt16Function();
+
+/// returns fastest span fill function for depths with bits (24 or 32) supported by the CPU the program is running on
+/// (32 bit depths are compared as unsigned values which AVX2 does not have so they are always one pixel at a time)
+SpanFillUInt32Function bestSpanFillUInt32Function(int bits);
+
+// MARK: IDs
+
+/// same as SpanFillFunction but also stores id in idRow[x] for each pixel that passes the depth test
+/// (idRow points to column 0 of the row like depthRow)
+typedef size_t (*SpanFillIDsFunction)(float *depthRow, Color *colorRow, uint32_t *idRow, int spanX, int firstX, int lastX, float z, float dz, const Color &color, uint32_t id);
+
+/// one pixel at a time version that stores IDs
+size_t spanFillIDsScalar(float *depthRow, Color *colorRow, uint32_t *idRow, int spanX, int firstX, int lastX, float z, float dz, const Color &color, uint32_t id);
+
+#ifdef SPAN_FILL_X86
+/// four pixels at a time version that stores IDs using SSE2
+size_t spanFillIDsSSE2(float *depthRow, Color *colorRow, uint32_t *idRow, int spanX, int firstX, int lastX, float z, float dz, const Color &color, uint32_t id);
+
+/// eight pixels at a time version that stores IDs using AVX2 (only call if the CPU supports it)
+size_t spanFillIDsAVX2(float *depthRow, Color *colorRow, uint32_t *idRow, int spanX, int firstX, int lastX, float z, float dz, const Color &color, uint32_t id);
+#endif
+
+/// returns fastest span fill function that stores IDs supported by the CPU the program is running on
+SpanFillIDsFunction bestSpanFillIDsFunction();
+
+/// spanFillIDsScalar for 16 bit integer depths mapped by mapping
+size_t spanFillUInt16IDsScalar(uint16_t *depthRow, Color *colorRow, uint32_t *idRow, int spanX, int firstX, int lastX, float z, float dz, const DepthMapping &mapping, const Color &color, uint32_t id);
+
+/// spanFillIDsScalar for 24 or 32 bit integer depths (stored in 32 bits) mapped by mapping
+size_t spanFillUInt32IDsScalar(uint32_t *depthRow, Color *colorRow, uint32_t *idRow, int spanX, int firstX, int lastX, float z, float dz, const DepthMapping &mapping, const Color &color, uint32_t id);
+
+#endif /* SpanFill_hpp */
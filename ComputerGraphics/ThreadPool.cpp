@@ -0,0 +1,87 @@
+//
+//  ThreadPool.cpp
+//  ComputerGraphics
+//
+//  Created by agent on 10/17/26.
+//  Copyright © 2026 agent. All rights reserved.
+//
+
+#include "ThreadPool.hpp"
+
+ThreadPool::ThreadPool() {
+    _function = nullptr;
+    _job = nullptr;
+    _jobNumber = 0;
+    _numBusy = 0;
+    _stop = false;
+}
+
+ThreadPool::~ThreadPool() {
+    _stopThreads();
+}
+
+void ThreadPool::setNumThreads(int numThreads) {
+    if (numThreads < 1) {
+        numThreads = 1;
+    }
+    if (numThreads == this->numThreads()) {
+        return;
+    }
+    // start over with the new number of threads (this only happens when the setting changes)
+    _stopThreads();
+    for (int i=1; i<numThreads; ++i) {
+        // given the current job number rather than reading it when it starts so it cannot miss the next job
+        _threads.push_back(std::thread(&ThreadPool::_work, this, _jobNumber));
+    }
+}
+
+void ThreadPool::_run(void (*function)(void *), void *job) {
+    if (!_threads.empty()) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _function = function;
+        _job = job;
+        _numBusy = int(_threads.size());
+        ++_jobNumber;
+        _wake.notify_all();
+    }
+
+    // this thread does its share too
+    function(job);
+
+    if (!_threads.empty()) {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _done.wait(lock, [this]() { return _numBusy == 0; });
+    }
+}
+
+void ThreadPool::_work(uint64_t lastJob) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (true) {
+        _wake.wait(lock, [&]() { return _stop || _jobNumber != lastJob; });
+        if (_stop) {
+            return;
+        }
+        lastJob = _jobNumber;
+        void (*function)(void *) = _function;
+        void *job = _job;
+        lock.unlock();
+        function(job);
+        lock.lock();
+        if (--_numBusy == 0) {
+            _done.notify_one();
+        }
+    }
+}
+
+void ThreadPool::_stopThreads() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+        _wake.notify_all();
+    }
+    for (auto &thread: _threads) {
+        thread.join();
+    }
+    _threads.clear();
+    _stop = false;
+}
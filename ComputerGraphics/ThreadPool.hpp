@@ -0,0 +1,74 @@
+//
+//  ThreadPool.hpp
+//  ComputerGraphics
+//
+//  Created by agent on 10/17/26.
+//  Copyright © 2026 agent. All rights reserved.
+//
+
+#ifndef ThreadPool_hpp
+#define ThreadPool_hpp
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// threads that are created once and woken to run the same job together, so work split over many threads
+/// many times (e.g., once per frame) does not create and join threads each time
+class ThreadPool {
+public:
+    /// create a pool with just the calling thread
+    ThreadPool();
+
+    /// wakes the threads so they return and joins them
+    ~ThreadPool();
+
+    /// set the number of threads that run each job (the calling thread and numThreads - 1 pool threads)
+    /// creates or joins pool threads only when the number changes
+    /// @param numThreads number of threads (at least 1)
+    void setNumThreads(int numThreads);
+
+    /// number of threads that run each job (including the calling thread)
+    int numThreads() const { return int(_threads.size()) + 1; }
+
+    /// call job() on every thread of the pool and on the calling thread, returning when all the calls have returned
+    /// (job must split the work itself, e.g., by having each call take items from a shared atomic counter)
+    /// does not allocate memory
+    /// @param job function object to call
+    template <typename Job>
+    void run(Job &job) { _run(&_call<Job>, &job); }
+
+private:
+    ThreadPool(const ThreadPool &);
+    ThreadPool& operator=(const ThreadPool &);
+
+    template <typename Job>
+    static void _call(void *job) { (*static_cast<Job*>(job))(); }
+
+    /// wake the pool threads to call function(job), call it on this thread too, and wait for the others
+    void _run(void (*function)(void *), void *job);
+
+    /// loop run by each pool thread: wait for a job after lastJob, run it, repeat until _stop
+    void _work(uint64_t lastJob);
+
+    /// join all the pool threads
+    void _stopThreads();
+
+    std::vector<std::thread> _threads;
+    std::mutex _mutex;
+    // signaled when there is a new job (or the threads should stop)
+    std::condition_variable _wake;
+    // signaled when the last pool thread finishes a job
+    std::condition_variable _done;
+    void (*_function)(void *);
+    void *_job;
+    // incremented for each job so a thread can tell a new job from the one it just ran
+    uint64_t _jobNumber;
+    // pool threads still running the current job
+    int _numBusy;
+    bool _stop;
+};
+
+#endif /* ThreadPool_hpp */
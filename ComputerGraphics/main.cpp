@@ -6,6 +6,7 @@
 //  Copyright (c) 2015 David Reed. All rights reserved.
 //
 
+#include <cstdlib>
 #include <iostream>
 
 using std::cout;
@@ -14,8 +15,13 @@ using std::cerr;
 using std::endl;
 using std::string;
 
+#include "ConvexPolygonRasterizer.hpp"
+
+// define HEADLESS to build without OpenGL/GLFW (ConvexPolygonRenderer.cpp, RenderBase, and OpenGLBase are not needed)
+#ifndef HEADLESS
 #include "graphics.hpp"
 #include "ConvexPolygonRenderer.hpp"
+#endif
 
 //----------------------------------------------------------------------
 
@@ -30,9 +36,48 @@ int main(int argc, const char * argv[]) {
         cin >> filename;
     }
 
+    // if an output image file is specified, render without creating a window
+    string outputFilename;
+    if (argc > 2) {
+        outputFilename = argv[2];
+    }
+#ifdef HEADLESS
+    else {
+        cout << "enter output filename: ";
+        cin >> outputFilename;
+    }
+#endif
+
+    if (!outputFilename.empty()) {
+        // any more pairs of input and output files are rendered by the same rasterizer
+        // (clearing it between them rather than making a new one)
+        ConvexPolygonRasterizer rasterizer(960, 540);
+        bool readOK = true;
+        for (int next = 3; ; next += 2) {
+            // still write the polygons read before any malformed input so the problem can be seen
+            if (!rasterizer.renderFile(filename)) {
+                cerr << "error reading: " << filename << endl;
+                readOK = false;
+            }
+            if (!rasterizer.writePPM(outputFilename)) {
+                cerr << "error writing: " << outputFilename << endl;
+                return EXIT_FAILURE;
+            }
+            if (next + 1 >= argc) {
+                break;
+            }
+            filename = argv[next];
+            outputFilename = argv[next + 1];
+            rasterizer.clear();
+        }
+        return readOK ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+#ifndef HEADLESS
     // create the class
     Renderer *renderer = new ConvexPolygonRenderer("ConvexPolygon", 960, 540, filename);
 
     // and enter the run loop
     renderer->runLoop();
+#endif
 }
@@ -24,6 +24,12 @@
 #  define M_PI  3.14159265358979323846
 #endif
 
+// when no OpenGL header has been included (e.g., headless rendering) define the types we need
+#ifndef GL_FLOAT
+typedef float GLfloat;
+typedef void GLvoid;
+#endif
+
 // Define a helpful macro for handling offsets into buffer objects
 #define BUFFER_OFFSET( offset )   ((GLvoid*) (offset))
 
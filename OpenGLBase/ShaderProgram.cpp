@@ -10,6 +10,8 @@
 #define _CRT_SECURE_NO_DEPRECATE
 #endif
 
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 #include "Utils.hpp"
 
@@ -60,6 +62,7 @@ void ShaderProgram::makeProgramFromShaderStrings(std::string vertexShader, std::
             delete [] logMsg;
         }
     }
+    _findLocations();
 }
 
 //----------------------------------------------------------------------
@@ -93,3 +96,114 @@ void ShaderProgram::compileShader(std::string shaderCode, GLenum shaderType) con
 
 //----------------------------------------------------------------------
 
+GLint ShaderProgram::uniformLocation(const std::string &name) const {
+    if (!_locations) {
+        return -1;
+    }
+    auto location = _locations->uniforms.find(name);
+    return location == _locations->uniforms.end() ? -1 : location->second;
+}
+
+//----------------------------------------------------------------------
+
+GLint ShaderProgram::attributeLocation(const std::string &name) const {
+    if (!_locations) {
+        return -1;
+    }
+    auto location = _locations->attributes.find(name);
+    return location == _locations->attributes.end() ? -1 : location->second;
+}
+
+//----------------------------------------------------------------------
+
+void ShaderProgram::setUniform(GLint location, GLint value) const {
+    if (_changed(location, &value, sizeof(value))) {
+        glUniform1i(location, value);
+    }
+}
+
+//----------------------------------------------------------------------
+
+void ShaderProgram::setUniform(GLint location, GLfloat value) const {
+    if (_changed(location, &value, sizeof(value))) {
+        glUniform1f(location, value);
+    }
+}
+
+//----------------------------------------------------------------------
+
+void ShaderProgram::setUniform(GLint location, GLfloat x, GLfloat y, GLfloat z) const {
+    GLfloat value[] = { x, y, z };
+    if (_changed(location, value, sizeof(value))) {
+        glUniform3f(location, x, y, z);
+    }
+}
+
+//----------------------------------------------------------------------
+
+void ShaderProgram::setUniform(GLint location, const mat4 &value) const {
+    // mat4 is stored by rows so OpenGL transposes it
+    if (_changed(location, static_cast<const GLfloat*>(value), 16 * sizeof(GLfloat))) {
+        glUniformMatrix4fv(location, 1, GL_TRUE, value);
+    }
+}
+
+//----------------------------------------------------------------------
+
+void ShaderProgram::_findLocations() {
+    // a new shared object so copies of the old program keep its locations
+    _locations = std::make_shared<_Locations>();
+
+    GLint count, maxLength;
+    glGetProgramiv(_program, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(_program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+    std::vector<GLchar> name(std::max(maxLength, 1));
+    for (GLint i=0; i<count; ++i) {
+        GLint size;
+        GLenum type;
+        glGetActiveUniform(_program, GLuint(i), GLsizei(name.size()), NULL, &size, &type, name.data());
+        string uniform(name.data());
+        // arrays are reported as name[0]
+        size_t bracket = uniform.find('[');
+        if (bracket != string::npos) {
+            uniform.erase(bracket);
+        }
+        GLint location = glGetUniformLocation(_program, uniform.c_str());
+        if (location >= 0) {
+            _locations->uniforms[uniform] = location;
+            if (location >= GLint(_locations->values.size())) {
+                _locations->values.resize(location + 1);
+            }
+        }
+    }
+
+    glGetProgramiv(_program, GL_ACTIVE_ATTRIBUTES, &count);
+    glGetProgramiv(_program, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, &maxLength);
+    name.resize(std::max(maxLength, 1));
+    for (GLint i=0; i<count; ++i) {
+        GLint size;
+        GLenum type;
+        glGetActiveAttrib(_program, GLuint(i), GLsizei(name.size()), NULL, &size, &type, name.data());
+        _locations->attributes[name.data()] = glGetAttribLocation(_program, name.data());
+    }
+}
+
+//----------------------------------------------------------------------
+
+bool ShaderProgram::_changed(GLint location, const void *value, size_t size) const {
+    if (location < 0) {
+        return false;
+    }
+    // locations not found when linking (such as elements of arrays after the first) are always set
+    if (!_locations || location >= GLint(_locations->values.size())) {
+        return true;
+    }
+    std::vector<unsigned char> &current = _locations->values[location];
+    if (current.size() == size && std::memcmp(current.data(), value, size) == 0) {
+        return false;
+    }
+    current.assign(static_cast<const unsigned char*>(value), static_cast<const unsigned char*>(value) + size);
+    return true;
+}
+
+//----------------------------------------------------------------------
@@ -9,7 +9,10 @@
 #ifndef ShaderProgram_hpp
 #define ShaderProgram_hpp
 
+#include <memory>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #ifndef __APPLE__
 #include <GL/glew.h>
@@ -17,6 +20,7 @@
 #endif
 
 #include "GLFW/glfw3.h"
+#include "Angel.hpp"
 
 
 class ShaderProgram {
@@ -46,9 +50,51 @@ public:
     /// use this ShaderProgram to render
     void useProgram() const { glUseProgram(_program); }
 
+    /// location of an active uniform (all of them are found when the program is linked)
+    /// this searches by name so find the location once and keep it
+    /// @param name name of the uniform (the name of an array without [0])
+    /// @return location of the uniform or -1 if the program does not have an active uniform with that name
+    GLint uniformLocation(const std::string &name) const;
+
+    /// location of an active vertex attribute (all of them are found when the program is linked)
+    /// @param name name of the attribute
+    /// @return location of the attribute or -1 if the program does not have an active attribute with that name
+    GLint attributeLocation(const std::string &name) const;
+
+    /// set an int (or sampler) uniform of this program, which must be in use
+    /// the OpenGL call is skipped if the uniform already has the value (copies of a ShaderProgram share what was set)
+    /// @param location location from uniformLocation (-1 is ignored)
+    /// @param value value to set
+    void setUniform(GLint location, GLint value) const;
+
+    /// set a float uniform (see setUniform for int)
+    void setUniform(GLint location, GLfloat value) const;
+
+    /// set a vec3 uniform (see setUniform for int)
+    void setUniform(GLint location, GLfloat x, GLfloat y, GLfloat z) const;
+
+    /// set a mat4 uniform (see setUniform for int)
+    void setUniform(GLint location, const mat4 &value) const;
+
 protected:
     GLuint _program;
 private:
+    /// locations and the last values set of the uniforms, shared by the copies of a ShaderProgram
+    struct _Locations {
+        std::unordered_map<std::string, GLint> uniforms;
+        std::unordered_map<std::string, GLint> attributes;
+        // indexed by location (bytes of the last value set, empty if never set)
+        std::vector<std::vector<unsigned char>> values;
+    };
+
+    /// find the locations of all active uniforms and attributes after linking
+    void _findLocations();
+
+    /// record the value for a uniform
+    /// @return false if the uniform already has the value so it does not need to be set
+    bool _changed(GLint location, const void *value, size_t size) const;
+
+    std::shared_ptr<_Locations> _locations;
     static GLuint _programCounter;
 };
 
@@ -14,12 +14,14 @@
 #include "ColoredPointDrawable.hpp"
 
 ShaderProgram ColoredPointDrawable::_shaderProgram;
+GLint ColoredPointDrawable::_projectionEyeLocation = -1;
+GLint ColoredPointDrawable::_objectLocation = -1;
 
-ColoredPointDrawable::ColoredPointDrawable(const std::vector<ColoredPoint3D> &pts, const GLfloat pointSize, const mat4 &objectTransformation) {
-    _numPoints = (unsigned int) pts.size();
+ColoredPointDrawable::ColoredPointDrawable(VertexBufferAllocator &vertexBuffers, const std::vector<ColoredPoint3D> &pts, const GLfloat pointSize, const mat4 &objectTransformation) {
+    unsigned int numPoints = (unsigned int) pts.size();
     _pointSize = pointSize;
-    // _numPoints * 6 since x, y, z, r, g, b for each point
-    auto points = std::make_unique<float[]>(_numPoints * 6);
+    // numPoints * 6 since x, y, z, r, g, b for each point
+    auto points = std::make_unique<float[]>(numPoints * 6);
     size_t index = 0;
     for (auto i = 0; i<pts.size(); ++i) {
         points[index++] = pts[i].x;
@@ -28,33 +30,35 @@ ColoredPointDrawable::ColoredPointDrawable(const std::vector<ColoredPoint3D> &pt
         points[index++] = pts[i].r;
         points[index++] = pts[i].g;
         points[index++] = pts[i].b;    }
-    glGenBuffers(1, &_buffer);
-    glBindBuffer(GL_ARRAY_BUFFER, _buffer);
-    glBufferData(GL_ARRAY_BUFFER, _numPoints * 6 * sizeof(GLfloat), &points[0], GL_STATIC_DRAW);
+    uploadVertices(vertexBuffers, points.get(), numPoints, 6 * sizeof(GLfloat));
     _drawType = GL_POINTS;
     _objectMatrix = objectTransformation;
 }
 
 ColoredPointDrawable::~ColoredPointDrawable() noexcept {
-    glDeleteBuffers(1, &_buffer);
 }
 
-void ColoredPointDrawable::render(const mat4 &projectionEyeMatrix) {
+void ColoredPointDrawable::beginBatch(const mat4 &projectionEyeMatrix) {
     _shaderProgram.useProgram();
-    shaderTransformations(_shaderProgram, projectionEyeMatrix, _objectMatrix);
+    shaderTransformations(_shaderProgram, _projectionEyeLocation, _objectLocation, projectionEyeMatrix, _objectMatrix);
     
     glPointSize(_pointSize);
     // layout value for vPosition
     glEnableVertexAttribArray(0);
     glEnableVertexAttribArray(1);
-    glBindBuffer(GL_ARRAY_BUFFER, _buffer);
+    glBindBuffer(GL_ARRAY_BUFFER, _vertices.buffer);
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(GLfloat), BUFFER_OFFSET(0));
     glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(GLfloat), BUFFER_OFFSET(3 * sizeof(GLfloat)));
+}
 
-    glDrawArrays(_drawType, 0, _numPoints);
+bool ColoredPointDrawable::canBatchWith(const Drawable &other) const {
+    auto points = dynamic_cast<const ColoredPointDrawable*>(&other);
+    return points != nullptr && sharesBatchState(other) && _pointSize == points->_pointSize;
 }
 
 void ColoredPointDrawable::setShaderProgram(const ShaderProgram &shaderProgram) {
     _shaderProgram = shaderProgram;
+    _projectionEyeLocation = _shaderProgram.uniformLocation("projectionEyeMatrix");
+    _objectLocation = _shaderProgram.uniformLocation("objectMatrix");
 }
 
@@ -22,26 +22,31 @@ class ColoredPointDrawable: public Drawable {
 
 public:
     /// create colored points
+    /// @param vertexBuffers allocator for the vertices
     /// @param pts vector of ColoredPoint3D t
     /// @param pointSize size of point (defaults to 1.0)
     /// @param objectTransformation transformation matrix to apply when rendering
-    ColoredPointDrawable(const std::vector<ColoredPoint3D> &pts, const GLfloat pointSize = 1.0, const mat4 &objectTransformation = mat4());
+    ColoredPointDrawable(VertexBufferAllocator &vertexBuffers, const std::vector<ColoredPoint3D> &pts, const GLfloat pointSize = 1.0, const mat4 &objectTransformation = mat4());
 
     ~ColoredPointDrawable() noexcept;
 
-    /// render with specified projection and eye transformation matrix
+    /// use the shader and set the uniforms and vertex attributes for drawing the points
     /// @param projectionEyeMatrix projection and eye matrix transformation
-    void render(const mat4 &projectionEyeMatrix) override;
+    void beginBatch(const mat4 &projectionEyeMatrix) override;
+
+    /// true if other is a ColoredPointDrawable drawn the same way with the same point size
+    bool canBatchWith(const Drawable &other) const override;
 
     /// set the ShaderProgram to be used by all ColoredPointDrawable instances
     /// @param shaderProgram shaderProgram to use for all ColoredPointDrawable instances
     static void setShaderProgram(const ShaderProgram &shaderProgram);
 
-private:    
-    unsigned int _buffer;
-    unsigned int _numPoints;
+private:
     GLfloat _pointSize;
     static ShaderProgram _shaderProgram;
+    // uniform locations in _shaderProgram (found when it is set)
+    static GLint _projectionEyeLocation;
+    static GLint _objectLocation;
 };
 
 #endif /* ColoredPointDrawable_hpp */
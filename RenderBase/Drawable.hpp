@@ -15,6 +15,7 @@
 
 #include <GLFW/glfw3.h>
 #include "ShaderProgram.hpp"
+#include "VertexBufferAllocator.hpp"
 #include "Angel.hpp"
 
 /// abstract class for drawable objects the Renderer class will render
@@ -22,7 +23,12 @@ class Drawable {
 public:
     Drawable() { _objectMatrix = mat4(); }
 
-    virtual ~Drawable() {}
+    /// frees the drawable's vertices (so it must not outlive the VertexBufferAllocator they came from)
+    virtual ~Drawable() {
+        if (_vertexBuffers != nullptr) {
+            _vertexBuffers->free(_vertices);
+        }
+    }
 
     /// set object transformation for drawable
     /// @param transform object transformation to use
@@ -34,27 +40,83 @@ public:
     mat4 objectTransformation() const { return _objectMatrix; }
 
     /// render with specified projection and eye transformation matrix
-    virtual void render(const mat4 &projectionEyeMatrix) = 0;
+    virtual void render(const mat4 &projectionEyeMatrix) {
+        beginBatch(projectionEyeMatrix);
+        glDrawArrays(_drawType, firstVertex(), _numVertices);
+    }
+
+    /// use the shader and set the uniforms and vertex attributes for drawing this drawable
+    /// and the ones after it that can be batched with it (see canBatchWith)
+    /// the vertex attributes point at the start of the vertex buffer so each drawable's vertices start at firstVertex()
+    /// @param projectionEyeMatrix projection and eye matrix transformation
+    virtual void beginBatch(const mat4 &projectionEyeMatrix) = 0;
+
+    /// true if this drawable can be drawn by the same glMultiDrawArrays call as other using the state other's beginBatch set
+    /// (same shader, vertex buffer, draw type, and uniform values)
+    /// @param other first drawable of the batch
+    virtual bool canBatchWith(const Drawable &) const { return false; }
+
+    /// OpenGL primitive the vertices are drawn as
+    GLenum drawType() const { return _drawType; }
+
+    /// index of the drawable's first vertex in its vertex buffer
+    GLint firstVertex() const { return GLint(_vertices.offset / _vertexStride); }
+
+    /// number of vertices drawn
+    GLsizei numVertices() const { return _numVertices; }
 
     /// default method to set matrices in shaders
-    /// @param shaderProgram the shader program
+    /// @param shaderProgram the shader program (which must be in use)
+    /// @param projectionEyeLocation location of the projectionEyeMatrix uniform
+    /// @param objectLocation location of the objectMatrix uniform
     /// @param projectionEyeMatrix projection and eye transformation
     /// @param objectMatrix object transformation
-    void shaderTransformations(const ShaderProgram &shaderProgram, const mat4 &projectionEyeMatrix, const mat4 objectMatrix);
+    void shaderTransformations(const ShaderProgram &shaderProgram, GLint projectionEyeLocation, GLint objectLocation, const mat4 &projectionEyeMatrix, const mat4 &objectMatrix);
 
 protected:
+    /// copy the drawable's vertices into a buffer shared with other drawables
+    /// @param vertexBuffers allocator to take the space from
+    /// @param data vertex data
+    /// @param numVertices number of vertices
+    /// @param vertexStride number of bytes for each vertex
+    void uploadVertices(VertexBufferAllocator &vertexBuffers, const void *data, GLsizei numVertices, GLsizei vertexStride) {
+        _vertexBuffers = &vertexBuffers;
+        _numVertices = numVertices;
+        _vertexStride = vertexStride;
+        _vertices = vertexBuffers.allocate(data, GLsizeiptr(numVertices) * vertexStride, vertexStride);
+    }
+
+    /// true if other uses the same vertex buffer, draw type, and object transformation
+    bool sharesBatchState(const Drawable &other) const;
+
+    // allocator the vertices came from and where they are
+    VertexBufferAllocator *_vertexBuffers = nullptr;
+    VertexBufferAllocator::Allocation _vertices;
+    GLsizei _numVertices = 0;
+    GLsizei _vertexStride = 1;
     // default OpenGL option for drawing
     GLenum _drawType = GL_POINTS;
     // transformation matrix
     mat4 _objectMatrix;
 };
 
-inline void Drawable::shaderTransformations(const ShaderProgram &shaderProgram, const mat4 &projectionEyeMatrix, const mat4 objectMatrix) {
-    GLuint projectionEye = glGetUniformLocation(shaderProgram.program(), "projectionEyeMatrix");
-    GLuint object = glGetUniformLocation(shaderProgram.program(), "objectMatrix");
+inline void Drawable::shaderTransformations(const ShaderProgram &shaderProgram, GLint projectionEyeLocation, GLint objectLocation, const mat4 &projectionEyeMatrix, const mat4 &objectMatrix) {
+    shaderProgram.setUniform(projectionEyeLocation, projectionEyeMatrix);
+    shaderProgram.setUniform(objectLocation, objectMatrix);
+}
 
-    glUniformMatrix4fv(projectionEye, 1, GL_TRUE, projectionEyeMatrix);
-    glUniformMatrix4fv(object, 1, GL_TRUE, objectMatrix);
+inline bool Drawable::sharesBatchState(const Drawable &other) const {
+    if (_vertices.buffer != other._vertices.buffer || _drawType != other._drawType) {
+        return false;
+    }
+    for (int row=0; row<4; ++row) {
+        for (int col=0; col<4; ++col) {
+            if (_objectMatrix[row][col] != other._objectMatrix[row][col]) {
+                return false;
+            }
+        }
+    }
+    return true;
 }
 
 #endif /* Drawable_hpp */
@@ -0,0 +1,75 @@
+//
+//  ImageDrawable.cpp
+//  ComputerGraphics
+//
+//  Created by agent on 10/17/26.
+//  Copyright © 2026 agent. All rights reserved.
+//
+
+#include "ImageDrawable.hpp"
+
+ShaderProgram ImageDrawable::_shaderProgram;
+GLint ImageDrawable::_projectionEyeLocation = -1;
+GLint ImageDrawable::_objectLocation = -1;
+GLint ImageDrawable::_imageLocation = -1;
+
+ImageDrawable::ImageDrawable(VertexBufferAllocator &vertexBuffers, int width, int height, const Color *pixels, const mat4 &objectTransformation) {
+    // x, y, z, s, t for each corner of the rectangle drawn as a triangle strip
+    GLfloat w = GLfloat(width);
+    GLfloat h = GLfloat(height);
+    GLfloat points[] = {
+        0, 0, 0, 0, 0,
+        w, 0, 0, 1, 0,
+        0, h, 0, 0, 1,
+        w, h, 0, 1, 1
+    };
+    uploadVertices(vertexBuffers, points, 4, 5 * sizeof(GLfloat));
+
+    _width = width;
+    // Color is three floats so the pixels can be uploaded as is
+    glGenTextures(1, &_texture);
+    glBindTexture(GL_TEXTURE_2D, _texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, width, height, 0, GL_RGB, GL_FLOAT, pixels);
+
+    _drawType = GL_TRIANGLE_STRIP;
+    _objectMatrix = objectTransformation;
+}
+
+ImageDrawable::~ImageDrawable() noexcept {
+    glDeleteTextures(1, &_texture);
+}
+
+void ImageDrawable::beginBatch(const mat4 &projectionEyeMatrix) {
+    _shaderProgram.useProgram();
+    shaderTransformations(_shaderProgram, _projectionEyeLocation, _objectLocation, projectionEyeMatrix, _objectMatrix);
+
+    // layout value for vPosition and vTexCoord
+    glEnableVertexAttribArray(0);
+    glEnableVertexAttribArray(1);
+    glBindBuffer(GL_ARRAY_BUFFER, _vertices.buffer);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), BUFFER_OFFSET(0));
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), BUFFER_OFFSET(3 * sizeof(GLfloat)));
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, _texture);
+    _shaderProgram.setUniform(_imageLocation, 0);
+}
+
+void ImageDrawable::updatePixels(int minX, int minY, int maxX, int maxY, const Color *pixels) {
+    glBindTexture(GL_TEXTURE_2D, _texture);
+    // rows of the rectangle are width colors apart
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, _width);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, minX, minY, maxX - minX + 1, maxY - minY + 1, GL_RGB, GL_FLOAT, pixels + minY * _width + minX);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+}
+
+void ImageDrawable::setShaderProgram(const ShaderProgram &shaderProgram) {
+    _shaderProgram = shaderProgram;
+    _projectionEyeLocation = _shaderProgram.uniformLocation("projectionEyeMatrix");
+    _objectLocation = _shaderProgram.uniformLocation("objectMatrix");
+    _imageLocation = _shaderProgram.uniformLocation("image");
+}
@@ -0,0 +1,62 @@
+//
+//  ImageDrawable.hpp
+//  ComputerGraphics
+//
+//  Created by agent on 10/17/26.
+//  Copyright © 2026 agent. All rights reserved.
+//
+
+#ifndef ImageDrawable_hpp
+#define ImageDrawable_hpp
+
+#ifndef __APPLE__
+#include <GL/glew.h>
+#endif
+
+#include "GLFW/glfw3.h"
+#include "Angel.hpp"
+#include "Color.hpp"
+#include "Drawable.hpp"
+#include "ShaderProgram.hpp"
+
+class ImageDrawable: public Drawable {
+
+public:
+    /// image drawn as a texture on a rectangle from (0, 0) to (width, height)
+    /// @param vertexBuffers allocator for the rectangle's vertices
+    /// @param width number of columns of pixels
+    /// @param height number of rows of pixels
+    /// @param pixels width * height colors, row by row starting with the bottom row
+    /// @param objectTransformation transformation matrix to apply when rendering
+    ImageDrawable(VertexBufferAllocator &vertexBuffers, int width, int height, const Color *pixels, const mat4 &objectTransformation = mat4());
+
+    ~ImageDrawable() noexcept;
+
+    /// use the shader and set the uniforms, texture, and vertex attributes for drawing the image
+    /// (images are not batched since each has its own texture)
+    /// @param projectionEyeMatrix projection and eye matrix transformation
+    void beginBatch(const mat4 &projectionEyeMatrix) override;
+
+    /// upload a rectangle of the image's pixels again after they changed
+    /// @param minX first column of the rectangle
+    /// @param minY first row of the rectangle
+    /// @param maxX last column of the rectangle (inclusive)
+    /// @param maxY last row of the rectangle (inclusive)
+    /// @param pixels all of the image's colors laid out as for the constructor
+    void updatePixels(int minX, int minY, int maxX, int maxY, const Color *pixels);
+
+    /// set the ShaderProgram to be used by all ImageDrawable instances
+    /// @param shaderProgram shaderProgram to use for all ImageDrawable instances
+    static void setShaderProgram(const ShaderProgram &shaderProgram);
+
+private:
+    unsigned int _texture;
+    int _width;
+    static ShaderProgram _shaderProgram;
+    // uniform locations in _shaderProgram (found when it is set)
+    static GLint _projectionEyeLocation;
+    static GLint _objectLocation;
+    static GLint _imageLocation;
+};
+
+#endif /* ImageDrawable_hpp */
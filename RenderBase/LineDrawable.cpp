@@ -9,12 +9,15 @@
 #include "LineDrawable.hpp"
 
 ShaderProgram LineDrawable::_shaderProgram;
+GLint LineDrawable::_projectionEyeLocation = -1;
+GLint LineDrawable::_objectLocation = -1;
+GLint LineDrawable::_colorLocation = -1;
 
-LineDrawable::LineDrawable(const std::vector<Line3D> lines, const Color &color, const mat4 &objectTransformation) {
-    _numLines = (unsigned int) lines.size();
+LineDrawable::LineDrawable(VertexBufferAllocator &vertexBuffers, const std::vector<Line3D> lines, const Color &color, const mat4 &objectTransformation) {
+    unsigned int numLines = (unsigned int) lines.size();
     _color = color;
-    // _numPoints * 6 since x, y, z for each end point of each line
-    auto points = std::make_unique<float[]>(_numLines * 6);
+    // numLines * 6 since x, y, z for each end point of each line
+    auto points = std::make_unique<float[]>(numLines * 6);
     size_t index = 0;
     for (auto i = 0; i<lines.size(); ++i) {
         Point3D p1 = lines[i].p1();
@@ -26,30 +29,35 @@ LineDrawable::LineDrawable(const std::vector<Line3D> lines, const Color &color,
         points[index++] = p2.y;
         points[index++] = p2.z;
     }
-    glGenBuffers(1, &_buffer);
-    glBindBuffer(GL_ARRAY_BUFFER, _buffer);
-    glBufferData(GL_ARRAY_BUFFER, _numLines * 6 * sizeof(GLfloat), &points[0], GL_STATIC_DRAW);
+    // two vertices for each line
+    uploadVertices(vertexBuffers, points.get(), 2 * numLines, 3 * sizeof(GLfloat));
+    _drawType = GL_LINES;
     _objectMatrix = objectTransformation;
 }
 
 LineDrawable::~LineDrawable() noexcept { 
-    glDeleteBuffers(1, &_buffer);
 }
 
-void LineDrawable::render(const mat4 &projectionEyeMatrix) { 
+void LineDrawable::beginBatch(const mat4 &projectionEyeMatrix) {
     _shaderProgram.useProgram();
-    shaderTransformations(_shaderProgram, projectionEyeMatrix, _objectMatrix);
+    shaderTransformations(_shaderProgram, _projectionEyeLocation, _objectLocation, projectionEyeMatrix, _objectMatrix);
     
     // layout value for vPosition
     glEnableVertexAttribArray(0);
-    glBindBuffer(GL_ARRAY_BUFFER, _buffer);
+    glBindBuffer(GL_ARRAY_BUFFER, _vertices.buffer);
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(GLfloat), BUFFER_OFFSET(0));
-    auto colorLocation = glGetUniformLocation(_shaderProgram.program(), "pointColor");
-    glUniform3f(colorLocation, _color.r, _color.g, _color.b);
-    // pass number of points so 2 * _numLines
-    glDrawArrays(GL_LINES, 0, 2 * _numLines);
+    _shaderProgram.setUniform(_colorLocation, _color.r, _color.g, _color.b);
+}
+
+bool LineDrawable::canBatchWith(const Drawable &other) const {
+    auto lines = dynamic_cast<const LineDrawable*>(&other);
+    return lines != nullptr && sharesBatchState(other) &&
+        _color.r == lines->_color.r && _color.g == lines->_color.g && _color.b == lines->_color.b;
 }
 
 void LineDrawable::setShaderProgram(const ShaderProgram &shaderProgram) { 
     _shaderProgram = shaderProgram;
+    _projectionEyeLocation = _shaderProgram.uniformLocation("projectionEyeMatrix");
+    _objectLocation = _shaderProgram.uniformLocation("objectMatrix");
+    _colorLocation = _shaderProgram.uniformLocation("pointColor");
 }
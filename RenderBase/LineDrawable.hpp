@@ -25,16 +25,20 @@ class LineDrawable: public Drawable {
 
 public:
     /// lines to render
+    /// @param vertexBuffers allocator for the vertices
     /// @param lines vector of Line3D to render
     /// @param color color for the lines
     /// @param objectTransformation transformation matrix to apply when rendering
-    LineDrawable(const std::vector<Line3D> lines, const Color &color, const mat4 &objectTransformation = mat4());
+    LineDrawable(VertexBufferAllocator &vertexBuffers, const std::vector<Line3D> lines, const Color &color, const mat4 &objectTransformation = mat4());
 
     ~LineDrawable() noexcept;
 
-    /// render with specified projection and eye transformation matrix
+    /// use the shader and set the uniforms and vertex attributes for drawing the lines
     /// @param projectionEyeMatrix projection and eye matrix transformation
-    void render(const mat4 &projectionEyeMatrix) override;
+    void beginBatch(const mat4 &projectionEyeMatrix) override;
+
+    /// true if other is a LineDrawable drawn the same way with the same color
+    bool canBatchWith(const Drawable &other) const override;
 
     /// set the ShaderProgram to be used by all LineDrawable instances
     /// @param shaderProgram shaderProgram to use for all LineDrawable instances
@@ -42,9 +46,11 @@ public:
 
 private:
     Color _color;
-    unsigned int _buffer;
-    unsigned int _numLines;
     static ShaderProgram _shaderProgram;
+    // uniform locations in _shaderProgram (found when it is set)
+    static GLint _projectionEyeLocation;
+    static GLint _objectLocation;
+    static GLint _colorLocation;
 };
 
 
@@ -9,45 +9,52 @@
 #include "PointDrawable.hpp"
 
 ShaderProgram PointDrawable::_shaderProgram;
+GLint PointDrawable::_projectionEyeLocation = -1;
+GLint PointDrawable::_objectLocation = -1;
+GLint PointDrawable::_colorLocation = -1;
 
-PointDrawable::PointDrawable(const std::vector<Point3D> &pts, const Color &color, const GLfloat pointSize, const mat4 objectTransformation) {
-    _numPoints = (unsigned int) pts.size();
+PointDrawable::PointDrawable(VertexBufferAllocator &vertexBuffers, const std::vector<Point3D> &pts, const Color &color, const GLfloat pointSize, const mat4 objectTransformation) {
+    unsigned int numPoints = (unsigned int) pts.size();
     _color = color;
     _pointSize = pointSize;
-    // _numPoints * 3 since x, y, z for each point
-    auto points = std::make_unique<float[]>(_numPoints * 3);
+    // numPoints * 3 since x, y, z for each point
+    auto points = std::make_unique<float[]>(numPoints * 3);
     size_t index = 0;
     for (auto i = 0; i<pts.size(); ++i) {
         points[index++] = pts[i].x;
         points[index++] = pts[i].y;
         points[index++] = pts[i].z;
     }
-    glGenBuffers(1, &_buffer);
-    glBindBuffer(GL_ARRAY_BUFFER, _buffer);
-    glBufferData(GL_ARRAY_BUFFER, _numPoints * 3 * sizeof(GLfloat), &points[0], GL_STATIC_DRAW);
+    uploadVertices(vertexBuffers, points.get(), numPoints, 3 * sizeof(GLfloat));
     _drawType = GL_POINTS;
     _objectMatrix = objectTransformation;
 }
 
 PointDrawable::~PointDrawable() noexcept {
-    glDeleteBuffers(1, &_buffer);
 }
 
-void PointDrawable::render(const mat4 &projectionEyeMatrix) {
+void PointDrawable::beginBatch(const mat4 &projectionEyeMatrix) {
     _shaderProgram.useProgram();
-    shaderTransformations(_shaderProgram, projectionEyeMatrix, _objectMatrix);
+    shaderTransformations(_shaderProgram, _projectionEyeLocation, _objectLocation, projectionEyeMatrix, _objectMatrix);
 
     glPointSize(_pointSize);
     // layout value for vPosition
     glEnableVertexAttribArray(0);
-    glBindBuffer(GL_ARRAY_BUFFER, _buffer);
+    glBindBuffer(GL_ARRAY_BUFFER, _vertices.buffer);
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(GLfloat), BUFFER_OFFSET(0));
-    auto colorLocation = glGetUniformLocation(_shaderProgram.program(), "pointColor");
-    glUniform3f(colorLocation, _color.r, _color.g, _color.b);
-    glDrawArrays(_drawType, 0, _numPoints);
+    _shaderProgram.setUniform(_colorLocation, _color.r, _color.g, _color.b);
+}
+
+bool PointDrawable::canBatchWith(const Drawable &other) const {
+    auto points = dynamic_cast<const PointDrawable*>(&other);
+    return points != nullptr && sharesBatchState(other) && _pointSize == points->_pointSize &&
+        _color.r == points->_color.r && _color.g == points->_color.g && _color.b == points->_color.b;
 }
 
 void PointDrawable::setShaderProgram(const ShaderProgram &shaderProgram) {
     _shaderProgram = shaderProgram;
+    _projectionEyeLocation = _shaderProgram.uniformLocation("projectionEyeMatrix");
+    _objectLocation = _shaderProgram.uniformLocation("objectMatrix");
+    _colorLocation = _shaderProgram.uniformLocation("pointColor");
 }
 
@@ -27,17 +27,21 @@ class PointDrawable: public Drawable {
 
 public:
     /// set of points to render
+    /// @param vertexBuffers allocator for the vertices
     /// @param pts vector of Point3D to render
     /// @param color color to use
     /// @param point size
     /// @param objectTransformation transformation matrix to apply when rendering
-    PointDrawable(const std::vector<Point3D> &pts, const Color &color, const GLfloat pointSize = 1.0, const mat4 objectTransformation = mat4());
+    PointDrawable(VertexBufferAllocator &vertexBuffers, const std::vector<Point3D> &pts, const Color &color, const GLfloat pointSize = 1.0, const mat4 objectTransformation = mat4());
 
     ~PointDrawable() noexcept;
 
-    /// render with specified projection and eye transformation matrix
+    /// use the shader and set the uniforms and vertex attributes for drawing the points
     /// @param projectionEyeMatrix projection and eye matrix transformation
-    void render(const mat4 &projectionEyeMatrix) override;
+    void beginBatch(const mat4 &projectionEyeMatrix) override;
+
+    /// true if other is a PointDrawable (or LineStripDrawable or PolyLineDrawable) drawn the same way with the same color and point size
+    bool canBatchWith(const Drawable &other) const override;
 
     /// set the ShaderProgram to be used by all PointDrawable instances
     /// @param shaderProgram shaderProgram to use for all PointDrawable instances
@@ -45,10 +49,12 @@ public:
 
 private:
     Color _color;
-    unsigned int _buffer;
-    unsigned int _numPoints;
     GLfloat _pointSize;
     static ShaderProgram _shaderProgram;
+    // uniform locations in _shaderProgram (found when it is set)
+    static GLint _projectionEyeLocation;
+    static GLint _objectLocation;
+    static GLint _colorLocation;
 };
 
 #endif /* PointDrawable_hpp */
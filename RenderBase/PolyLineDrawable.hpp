@@ -14,17 +14,18 @@
 class PolyLineDrawable: public PointDrawable {
 public:
     /// PolyLine (line between each point and between first and last points) using specified points
+    /// @param vertexBuffers allocator for the vertices
     /// @param pts vector of Point3D for the polyline
     /// @param color color for the polyline
     /// @param objectTransformation transformation matrix to apply when rendering
-    PolyLineDrawable(const std::vector<Point3D> &pts, const Color &color, const mat4 &objectTransformation = mat4());
+    PolyLineDrawable(VertexBufferAllocator &vertexBuffers, const std::vector<Point3D> &pts, const Color &color, const mat4 &objectTransformation = mat4());
 
     ~PolyLineDrawable() noexcept {}
 
 private:
 };
 
-inline PolyLineDrawable::PolyLineDrawable(const std::vector<Point3D> &pts, const Color &color, const mat4 &objectTransformation): PointDrawable(pts, color, 1.0, objectTransformation) {
+inline PolyLineDrawable::PolyLineDrawable(VertexBufferAllocator &vertexBuffers, const std::vector<Point3D> &pts, const Color &color, const mat4 &objectTransformation): PointDrawable(vertexBuffers, pts, color, 1.0, objectTransformation) {
     // same as points except draw as line loop
     _drawType = GL_LINE_LOOP;
 }
@@ -99,6 +99,53 @@ Renderer::Renderer(std::string windowTitle, int width, int height) : GLFWBase(wi
     ShaderProgram program2;
     program2.makeProgramFromShaderStrings(coloredPointVShader, coloredPointFShader);
     ColoredPointDrawable::setShaderProgram(program2);
+
+    // vertex shader for images
+    string imageVShader = R"(
+    #version 330 core
+
+    // Input vertex data, different for all executions of this shader.
+    layout(location = 0) in vec3 vPosition;
+    layout(location = 1) in vec2 vTexCoord;
+
+    uniform mat4 projectionEyeMatrix;
+    uniform mat4 objectMatrix;
+
+    out vec2 texCoord;
+
+    void main()
+    {
+      // vertex shader must set gl_Position
+      gl_Position = projectionEyeMatrix * objectMatrix * vec4(vPosition, 1);
+      texCoord = vTexCoord;
+    }
+    )";
+
+    // fragment shader for images
+    string imageFShader = R"(
+    #version 330 core
+
+    // value representing interpolated texture coordinate
+    in vec2 texCoord;
+
+    // texture holding the image
+    uniform sampler2D image;
+
+    // color to use for fragment
+    out vec4 finalColor;
+
+    void main()
+    {
+      finalColor = texture(image, texCoord);
+    }
+    )";
+
+//	vertexPath = pathUsingEnvironmentVariable("imageVShader.txt", "GL_SHADER_DIR");
+//	shaderPath = pathUsingEnvironmentVariable("imageFShader.txt", "GL_SHADER_DIR");
+
+    ShaderProgram program3;
+    program3.makeProgramFromShaderStrings(imageVShader, imageFShader);
+    ImageDrawable::setShaderProgram(program3);
 }
 
 Renderer::~Renderer() noexcept {
@@ -113,38 +160,96 @@ void Renderer::mouseButtonCallback(GLFWwindow* window, int button, int action, i
     }
 }
 
-size_t Renderer::addPoints(const std::vector<Point3D> &pts, const Color &color, float pointSize, const mat4 &objectTransformation) {
-    auto drawable = std::make_shared<PointDrawable>(pts, color, displayScale() * pointSize, objectTransformation);
-    _objects.push_back(drawable);
-    return _objects.size() - 1;
+DrawableHandle Renderer::addPoints(const std::vector<Point3D> &pts, const Color &color, float pointSize, const mat4 &objectTransformation) {
+    auto drawable = std::make_shared<PointDrawable>(_vertexBuffers, pts, color, displayScale() * pointSize, objectTransformation);
+    return _addDrawable(drawable);
+}
+
+DrawableHandle Renderer::addColoredPoints(const std::vector<ColoredPoint3D> &pts, const float pointSize, const mat4 &objectTransformation) {
+    auto drawable = std::make_shared<ColoredPointDrawable>(_vertexBuffers, pts, displayScale() * pointSize, objectTransformation);
+    return _addDrawable(drawable);
+}
+
+DrawableHandle Renderer::addLines(const std::vector<Line3D> &lines, const Color &color, const mat4 &objectTransformation) {
+    auto drawable = std::make_shared<LineDrawable>(_vertexBuffers, lines, color, objectTransformation);
+    return _addDrawable(drawable);
 }
 
-size_t Renderer::addColoredPoints(const std::vector<ColoredPoint3D> &pts, const float pointSize, const mat4 &objectTransformation) {
-    auto drawable = std::make_shared<ColoredPointDrawable>(pts, displayScale() * pointSize, objectTransformation);
-    _objects.push_back(drawable);
-    return _objects.size() - 1;
+DrawableHandle Renderer::addLineStrip(const std::vector<Point3D> &pts, const Color &color, const mat4 &objectTransformation) {
+    auto drawable = std::make_shared<LineStripDrawable>(_vertexBuffers, pts, color, objectTransformation);
+    return _addDrawable(drawable);
 }
 
-size_t Renderer::addLines(const std::vector<Line3D> &lines, const Color &color, const mat4 &objectTransformation) {
-    auto drawable = std::make_shared<LineDrawable>(lines, color, objectTransformation);
-    _objects.push_back(drawable);
-    return _objects.size() - 1;
+DrawableHandle Renderer::addPolyLine(const std::vector<Point3D> &pts, const Color &color, const mat4 &objectTransformation) {
+    auto drawable = std::make_shared<PolyLineDrawable>(_vertexBuffers, pts, color, objectTransformation);
+    return _addDrawable(drawable);
 }
 
-size_t Renderer::addLineStrip(const std::vector<Point3D> &pts, const Color &color, const mat4 &objectTransformation) {
-    auto drawable = std::make_shared<LineStripDrawable>(pts, color, objectTransformation);
-    _objects.push_back(drawable);
-    return _objects.size() - 1;
+DrawableHandle Renderer::addImage(int width, int height, const Color *pixels, const mat4 &objectTransformation) {
+    auto drawable = std::make_shared<ImageDrawable>(_vertexBuffers, width, height, pixels, objectTransformation);
+    return _addDrawable(drawable);
 }
 
-size_t Renderer::addPolyLine(const std::vector<Point3D> &pts, const Color &color, const mat4 &objectTransformation) {
-    auto drawable = std::make_shared<PolyLineDrawable>(pts, color, objectTransformation);
-    _objects.push_back(drawable);
-    return _objects.size() - 1;
+void Renderer::removeDrawable(DrawableHandle handle) {
+    if (!isValid(handle)) {
+        return;
+    }
+    _Slot &slot = _slots[handle.index];
+
+    // unlink it from the draw order
+    if (slot.previous != NoSlot) {
+        _slots[slot.previous].next = slot.next;
+    }
+    else {
+        _firstSlot = slot.next;
+    }
+    if (slot.next != NoSlot) {
+        _slots[slot.next].previous = slot.previous;
+    }
+    else {
+        _lastSlot = slot.previous;
+    }
+
+    // a new generation so handles to the removed drawable are not valid for the next one in the slot
+    slot.drawable.reset();
+    if (++slot.generation == 0) {
+        slot.generation = 1;
+    }
+    slot.next = _freeSlot;
+    _freeSlot = handle.index;
+    --_numDrawables;
 }
 
-void Renderer::removeDrawable(size_t position) {
-    _objects.erase(_objects.begin() + position);
+DrawableHandle Renderer::_addDrawable(std::shared_ptr<Drawable> drawable) {
+    uint32_t index;
+    if (_freeSlot != NoSlot) {
+        index = _freeSlot;
+        _freeSlot = _slots[index].next;
+    }
+    else {
+        index = uint32_t(_slots.size());
+        _Slot slot;
+        slot.generation = 1;
+        _slots.push_back(slot);
+    }
+
+    _Slot &slot = _slots[index];
+    slot.drawable = std::move(drawable);
+    slot.previous = _lastSlot;
+    slot.next = NoSlot;
+    if (_lastSlot != NoSlot) {
+        _slots[_lastSlot].next = index;
+    }
+    else {
+        _firstSlot = index;
+    }
+    _lastSlot = index;
+    ++_numDrawables;
+
+    DrawableHandle handle;
+    handle.index = index;
+    handle.generation = slot.generation;
+    return handle;
 }
 
 void Renderer::render() {
@@ -164,8 +269,29 @@ void Renderer::render() {
     float h = float(windowHeight());
     mat4 projectionEyeMatrix = Translate(-1.0f, -1.0f, 0.0f) * Scale(2.0f / w, 2.0f / h, 1.0f);
 
-    // draw each added drawable with the transformation
-    for (auto i=0; i<_objects.size(); ++i) {
-        _objects[i]->render(projectionEyeMatrix);
+    // draw the added drawables in order with the transformation
+    // consecutive drawables that can be batched are drawn with one glMultiDrawArrays call
+    // using the shader and uniform values set by the first one
+    uint32_t slot = _firstSlot;
+    while (slot != NoSlot) {
+        Drawable &first = *_slots[slot].drawable;
+        first.beginBatch(projectionEyeMatrix);
+        _batchFirsts.clear();
+        _batchCounts.clear();
+        do {
+            _batchFirsts.push_back(_slots[slot].drawable->firstVertex());
+            _batchCounts.push_back(_slots[slot].drawable->numVertices());
+            slot = _slots[slot].next;
+        } while (slot != NoSlot && _slots[slot].drawable->canBatchWith(first));
+
+        if (_batchFirsts.size() == 1) {
+            glDrawArrays(first.drawType(), _batchFirsts[0], _batchCounts[0]);
+        }
+        else {
+            glMultiDrawArrays(first.drawType(), _batchFirsts.data(), _batchCounts.data(), GLsizei(_batchFirsts.size()));
+        }
     }
+
+    // vertices of drawables removed before this frame can be reused once the GPU finishes it
+    _vertexBuffers.endFrame();
 }
@@ -9,6 +9,7 @@
 #ifndef Renderer_hpp
 #define Renderer_hpp
 
+#include <cstdint>
 #include <memory>
 #include <vector>
 #include "GLFWBase.hpp"
@@ -17,6 +18,15 @@
 #include "Color.hpp"
 #include "Drawable.hpp"
 
+/// identifies a drawable added to a Renderer
+/// it stays valid until the drawable is removed and never refers to a drawable added later
+struct DrawableHandle {
+    /// slot the drawable is stored in
+    uint32_t index = 0;
+    /// number the slot had when the drawable was added (0 is never used so a default handle is invalid)
+    uint32_t generation = 0;
+};
+
 class Renderer : public GLFWBase {
 
 public:
@@ -42,51 +52,91 @@ public:
     /// @param color color to render each point in
     /// @param pointSize size of each point (defaults to 1.0)
     /// @param objectTransformation transformation to apply to each point (defaults to identity matrix)
-    /// @return position identifier for the drawable added (can be sent to removeDrawable method)
-    size_t addPoints(const std::vector<Point3D> &pts, const Color &color, float pointSize = 1.0, const mat4 &objectTransformation = mat4());
+    /// @return handle for the drawable added (can be sent to removeDrawable method)
+    DrawableHandle addPoints(const std::vector<Point3D> &pts, const Color &color, float pointSize = 1.0, const mat4 &objectTransformation = mat4());
 
     /// add colored points to be rendered
     /// @param pts vector of ColoredPoint3D to render
     /// @param pointSize size of each point (defaults to 1.0)
     /// @param objectTransformation transformation to apply to each point (defaults to identity matrix)
-    /// @return position identifier for the drawable added (can be sent to removeDrawable method)
-    size_t addColoredPoints(const std::vector<ColoredPoint3D> &pts, const float pointSize = 1.0, const mat4 &objectTransformation = mat4());
+    /// @return handle for the drawable added (can be sent to removeDrawable method)
+    DrawableHandle addColoredPoints(const std::vector<ColoredPoint3D> &pts, const float pointSize = 1.0, const mat4 &objectTransformation = mat4());
 
     /// add lines to be rendered
     /// @param lines vector of Line3D to render
     /// @param color color for the lines
     /// @param objectTransformation transformation to apply to each point (defaults to identity matrix)
-    /// @return position identifier for the drawable added (can be sent to removeDrawable method)
-    size_t addLines(const std::vector<Line3D> &lines, const Color &color, const mat4 &objectTransformation = mat4());
+    /// @return handle for the drawable added (can be sent to removeDrawable method)
+    DrawableHandle addLines(const std::vector<Line3D> &lines, const Color &color, const mat4 &objectTransformation = mat4());
 
     /// add a line strip to be rendered
     /// @param pts vector of Point3D that define the line strip
     /// @param color color for the line strip
     /// @param objectTransformation transformation to apply to each point (defaults to identity matrix)
-    /// @return position identifier for the drawable added (can be sent to removeDrawable method)
-    size_t addLineStrip(const std::vector<Point3D> &pts, const Color &color, const mat4 &objectTransformation = mat4());
+    /// @return handle for the drawable added (can be sent to removeDrawable method)
+    DrawableHandle addLineStrip(const std::vector<Point3D> &pts, const Color &color, const mat4 &objectTransformation = mat4());
 
     /// add a polyline to be rendered
     /// @param pts vector of Point3D that define the polyline
     /// @param color color for the polyline
     /// @param objectTransformation transformation to apply to each point (defaults to identity matrix)
-    /// @return position identifier for the drawable added (can be sent to removeDrawable method)
-    size_t addPolyLine(const std::vector<Point3D> &pts, const Color &color, const mat4 &objectTransformation = mat4());
+    /// @return handle for the drawable added (can be sent to removeDrawable method)
+    DrawableHandle addPolyLine(const std::vector<Point3D> &pts, const Color &color, const mat4 &objectTransformation = mat4());
+
+    /// add an image to be rendered covering the rectangle from (0, 0) to (width, height)
+    /// @param width number of columns of pixels
+    /// @param height number of rows of pixels
+    /// @param pixels width * height colors, row by row starting with the bottom row
+    /// @param objectTransformation transformation to apply to the image rectangle (defaults to identity matrix)
+    /// @return handle for the drawable added (can be sent to removeDrawable method)
+    DrawableHandle addImage(int width, int height, const Color *pixels, const mat4 &objectTransformation = mat4());
+
+    /// return Drawable with specified handle (nullptr if it has been removed)
+    std::shared_ptr<Drawable> operator[](DrawableHandle handle) const {
+        return isValid(handle) ? _slots[handle.index].drawable : nullptr;
+    }
 
-    /// return Drawable at specified position
-    std::shared_ptr<Drawable> operator[](size_t pos) const {
-        return _objects[pos];
+    /// true if the handle refers to a drawable that has not been removed
+    bool isValid(DrawableHandle handle) const {
+        return handle.index < _slots.size() && _slots[handle.index].generation == handle.generation && _slots[handle.index].drawable;
     }
 
-    /// remove drawable with specified position so it is not rendered in subsequent window re-draws
-    /// @param position position identifier for drawable that is to be removed
-    void removeDrawable(size_t position);
+    /// number of drawables added and not removed
+    size_t numDrawables() const { return _numDrawables; }
+
+    /// remove drawable with specified handle so it is not rendered in subsequent window re-draws
+    /// takes constant time and does not change the handles of other drawables (a handle already removed is ignored)
+    /// @param handle handle of the drawable that is to be removed
+    void removeDrawable(DrawableHandle handle);
 
     // override the render method
     virtual void render() override;
 
 protected:
-    std::vector<std::shared_ptr<Drawable>> _objects;
+    /// slot of the drawables (linked in the order they are drawn, or into the free list)
+    struct _Slot {
+        std::shared_ptr<Drawable> drawable;
+        uint32_t generation;
+        uint32_t previous, next;
+    };
+
+    /// end of a list of slots
+    static const uint32_t NoSlot = UINT32_MAX;
+
+    /// store a drawable in a free slot at the end of the draw order
+    DrawableHandle _addDrawable(std::shared_ptr<Drawable> drawable);
+
+    // vertices of all the drawables (declared before _slots so it is destroyed after them)
+    VertexBufferAllocator _vertexBuffers;
+    std::vector<_Slot> _slots;
+    // first and last slots in draw order and first unused slot (the free list is linked by next)
+    uint32_t _firstSlot = NoSlot;
+    uint32_t _lastSlot = NoSlot;
+    uint32_t _freeSlot = NoSlot;
+    size_t _numDrawables = 0;
+    // first vertex and number of vertices of each drawable in a batch (kept to reuse their memory)
+    std::vector<GLint> _batchFirsts;
+    std::vector<GLsizei> _batchCounts;
 };
 
 #endif /* Renderer_hpp */
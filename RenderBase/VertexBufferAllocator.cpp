@@ -0,0 +1,174 @@
+//
+//  VertexBufferAllocator.cpp
+//  ComputerGraphics
+//
+//  Created by agent on 10/17/26.
+//  Copyright © 2026 agent. All rights reserved.
+//
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include "VertexBufferAllocator.hpp"
+
+VertexBufferAllocator::VertexBufferAllocator(GLsizeiptr blockSize) {
+    _blockSize = blockSize;
+    _persistent = false;
+    _checkedPersistent = false;
+}
+
+VertexBufferAllocator::~VertexBufferAllocator() noexcept {
+    for (auto &pending: _pending) {
+        glDeleteSync(pending.fence);
+    }
+    for (auto &block: _blocks) {
+        if (block.mapped != nullptr) {
+            glBindBuffer(GL_ARRAY_BUFFER, block.buffer);
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+        }
+        glDeleteBuffers(1, &block.buffer);
+    }
+}
+
+VertexBufferAllocator::Allocation VertexBufferAllocator::allocate(const void *data, GLsizeiptr size, GLsizeiptr stride) {
+    // reserve whole floats (and something for no vertices so the buffer can still be bound)
+    GLsizeiptr reserved = std::max((size + 3) / 4 * 4, GLsizeiptr(4));
+
+    Allocation allocation;
+    allocation.size = reserved;
+    allocation.block = _blocks.size();
+    for (size_t i=0; i<_blocks.size() && allocation.block == _blocks.size(); ++i) {
+        if (_takeRange(i, reserved, stride, allocation.offset)) {
+            allocation.block = i;
+        }
+    }
+    if (allocation.block == _blocks.size()) {
+        // memory the GPU has finished with may be enough before adding a buffer
+        _releaseCompleted();
+        for (size_t i=0; i<_blocks.size() && allocation.block == _blocks.size(); ++i) {
+            if (_takeRange(i, reserved, stride, allocation.offset)) {
+                allocation.block = i;
+            }
+        }
+    }
+    if (allocation.block == _blocks.size()) {
+        _addBlock(std::max(_blockSize, reserved + stride));
+        _takeRange(allocation.block, reserved, stride, allocation.offset);
+    }
+
+    _Block &block = _blocks[allocation.block];
+    allocation.buffer = block.buffer;
+    if (size > 0) {
+        if (block.mapped != nullptr) {
+            // the range is not used by any frame the GPU may still be drawing so it can be written directly
+            std::memcpy(block.mapped + allocation.offset, data, size_t(size));
+        }
+        else {
+            glBindBuffer(GL_ARRAY_BUFFER, block.buffer);
+            glBufferSubData(GL_ARRAY_BUFFER, allocation.offset, size, data);
+        }
+    }
+    return allocation;
+}
+
+void VertexBufferAllocator::free(const Allocation &allocation) {
+    _freedThisFrame.push_back(allocation);
+}
+
+void VertexBufferAllocator::endFrame() {
+    if (!_freedThisFrame.empty()) {
+        _PendingFrees pending;
+        pending.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        pending.allocations.swap(_freedThisFrame);
+        _pending.push_back(std::move(pending));
+    }
+    _releaseCompleted();
+}
+
+void VertexBufferAllocator::_addBlock(GLsizeiptr size) {
+    if (!_checkedPersistent) {
+#if !defined(__APPLE__) && defined(GL_MAP_PERSISTENT_BIT)
+        _persistent = GLEW_ARB_buffer_storage != 0;
+#endif
+        _checkedPersistent = true;
+    }
+
+    _Block block;
+    block.size = size;
+    block.mapped = nullptr;
+    block.free[0] = size;
+    glGenBuffers(1, &block.buffer);
+    glBindBuffer(GL_ARRAY_BUFFER, block.buffer);
+#if !defined(__APPLE__) && defined(GL_MAP_PERSISTENT_BIT)
+    if (_persistent) {
+        // coherent so writes are seen by draws without flushing
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(GL_ARRAY_BUFFER, size, nullptr, flags);
+        block.mapped = static_cast<char*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, size, flags));
+    }
+#endif
+    if (block.mapped == nullptr) {
+        glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
+    }
+    _blocks.push_back(std::move(block));
+}
+
+bool VertexBufferAllocator::_takeRange(size_t block, GLsizeiptr size, GLsizeiptr stride, GLintptr &offset) {
+    auto &free = _blocks[block].free;
+    for (auto range = free.begin(); range != free.end(); ++range) {
+        GLintptr start = range->first;
+        GLintptr end = range->first + range->second;
+        GLintptr aligned = (start + stride - 1) / stride * stride;
+        if (aligned + size <= end) {
+            // the parts before and after the allocation stay free
+            free.erase(range);
+            if (aligned > start) {
+                free[start] = aligned - start;
+            }
+            if (aligned + size < end) {
+                free[aligned + size] = end - aligned - size;
+            }
+            offset = aligned;
+            return true;
+        }
+    }
+    return false;
+}
+
+void VertexBufferAllocator::_releaseRange(const Allocation &allocation) {
+    auto &free = _blocks[allocation.block].free;
+    GLintptr offset = allocation.offset;
+    GLsizeiptr size = allocation.size;
+
+    // merge with the free range after it
+    auto next = free.find(offset + size);
+    if (next != free.end()) {
+        size += next->second;
+        free.erase(next);
+    }
+    // merge with the free range before it
+    auto after = free.lower_bound(offset);
+    if (after != free.begin()) {
+        auto previous = std::prev(after);
+        if (previous->first + previous->second == offset) {
+            previous->second += size;
+            return;
+        }
+    }
+    free[offset] = size;
+}
+
+void VertexBufferAllocator::_releaseCompleted() {
+    // fences are signaled in the order they were inserted so stop at the first one that is not
+    while (!_pending.empty()) {
+        GLenum status = glClientWaitSync(_pending.front().fence, 0, 0);
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+            break;
+        }
+        glDeleteSync(_pending.front().fence);
+        for (const Allocation &allocation: _pending.front().allocations) {
+            _releaseRange(allocation);
+        }
+        _pending.pop_front();
+    }
+}
@@ -0,0 +1,110 @@
+//
+//  VertexBufferAllocator.hpp
+//  ComputerGraphics
+//
+//  Created by agent on 10/17/26.
+//  Copyright © 2026 agent. All rights reserved.
+//
+
+#ifndef VertexBufferAllocator_hpp
+#define VertexBufferAllocator_hpp
+
+#include <deque>
+#include <map>
+#include <vector>
+
+#ifndef __APPLE__
+#include <GL/glew.h>
+#endif
+
+#include "GLFW/glfw3.h"
+
+/// sub-allocates vertex data for drawables from a few large OpenGL buffers
+/// so adding a drawable copies its vertices instead of creating a buffer object
+/// the buffers are persistently mapped when the driver supports it (GL_ARB_buffer_storage);
+/// otherwise the vertices are uploaded with glBufferSubData
+/// freed memory is reused only after a fence shows the GPU has finished the frames that could draw it
+class VertexBufferAllocator {
+public:
+    /// part of one of the buffers holding a drawable's vertices
+    struct Allocation {
+        /// OpenGL buffer to bind
+        GLuint buffer;
+        /// offset in bytes of the vertices in the buffer
+        GLintptr offset;
+        /// number of bytes reserved
+        GLsizeiptr size;
+        /// index of the buffer in the allocator
+        size_t block;
+    };
+
+    /// constructor (does not make any OpenGL calls; buffers are created when first needed)
+    /// @param blockSize size in bytes of each buffer (vertices larger than this get a buffer of their own)
+    VertexBufferAllocator(GLsizeiptr blockSize = 4 << 20);
+
+    /// deletes the buffers and fences so it must be destroyed while the OpenGL context still exists
+    ~VertexBufferAllocator() noexcept;
+
+    /// reserve space for vertices and copy them into it
+    /// the offset is a multiple of stride so offset / stride is the index of the first vertex
+    /// when the vertex attributes point at the start of the buffer (as glMultiDrawArrays needs)
+    /// @param data vertex data
+    /// @param size number of bytes of data
+    /// @param stride number of bytes for each vertex (a multiple of 4)
+    /// @return where the data is
+    Allocation allocate(const void *data, GLsizeiptr size, GLsizeiptr stride);
+
+    /// free an allocation (it is reused after the frames drawn before the next endFrame have finished)
+    /// @param allocation value returned by allocate
+    void free(const Allocation &allocation);
+
+    /// call after submitting each frame's draw calls
+    /// fences the allocations freed during the frame and makes the ones the GPU is done with available
+    void endFrame();
+
+    /// number of OpenGL buffers created
+    size_t numBuffers() const { return _blocks.size(); }
+
+    /// true if the buffers are persistently mapped
+    bool isPersistentlyMapped() const { return _persistent; }
+
+private:
+    VertexBufferAllocator(const VertexBufferAllocator &);
+    VertexBufferAllocator& operator=(const VertexBufferAllocator &);
+
+    struct _Block {
+        GLuint buffer;
+        GLsizeiptr size;
+        // memory the buffer is mapped to (nullptr if not persistently mapped)
+        char *mapped;
+        // free ranges (offset to size) with no two adjacent
+        std::map<GLintptr, GLsizeiptr> free;
+    };
+
+    struct _PendingFrees {
+        GLsync fence;
+        std::vector<Allocation> allocations;
+    };
+
+    /// create a buffer of size bytes that is all free
+    void _addBlock(GLsizeiptr size);
+
+    /// take size bytes starting at a multiple of stride from a block's free ranges (first fit)
+    /// @return false if no free range is large enough
+    bool _takeRange(size_t block, GLsizeiptr size, GLsizeiptr stride, GLintptr &offset);
+
+    /// add a range back to its block's free ranges, merging it with its neighbors
+    void _releaseRange(const Allocation &allocation);
+
+    /// release the ranges of the fences the GPU has passed
+    void _releaseCompleted();
+
+    GLsizeiptr _blockSize;
+    bool _persistent;
+    bool _checkedPersistent;
+    std::vector<_Block> _blocks;
+    std::vector<Allocation> _freedThisFrame;
+    std::deque<_PendingFrees> _pending;
+};
+
+#endif /* VertexBufferAllocator_hpp */
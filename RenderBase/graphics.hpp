@@ -26,12 +26,14 @@
 #include "Point.hpp"
 #include "Color.hpp"
 #include "Line.hpp"
+#include "VertexBufferAllocator.hpp"
 #include "Drawable.hpp"
 #include "PointDrawable.hpp"
 #include "ColoredPointDrawable.hpp"
 #include "PolyLineDrawable.hpp"
 #include "LineStripDrawable.hpp"
 #include "LineDrawable.hpp"
+#include "ImageDrawable.hpp"
 #include "Renderer.hpp"
 
 
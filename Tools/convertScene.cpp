@@ -0,0 +1,53 @@
+//
+//  convertScene.cpp
+//  ComputerGraphics
+//
+//  Created by agent on 10/17/26.
+//  Copyright © 2026 agent. All rights reserved.
+//
+//  converts a text scene file (e.g., DataFiles/in1.txt) to a binary scene file (see SceneFile.hpp)
+//  built as the convertScene target of CMakeLists.txt
+//
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "ConvexPolygon.hpp"
+#include "SceneFile.hpp"
+#include "SceneParser.hpp"
+
+using namespace std;
+
+int main(int argc, char **argv) {
+    if (argc < 3) {
+        cerr << "usage: " << argv[0] << " input.txt output.bin [--no-bounding-boxes]" << endl;
+        return EXIT_FAILURE;
+    }
+    string inputFilename = argv[1];
+    string outputFilename = argv[2];
+    bool boundingBoxes = !(argc > 3 && string(argv[3]) == "--no-bounding-boxes");
+
+    SceneParser parser(inputFilename);
+    if (!parser.isOpen()) {
+        cerr << "error opening: " << inputFilename << endl;
+        return EXIT_FAILURE;
+    }
+    vector<ConvexPolygon> polygons;
+    ConvexPolygon polygon;
+    while (parser.readPolygon(polygon)) {
+        polygons.push_back(polygon);
+    }
+    if (parser.failed()) {
+        cerr << parser.error() << endl;
+        return EXIT_FAILURE;
+    }
+
+    if (!SceneFile::write(outputFilename, polygons, boundingBoxes)) {
+        cerr << "error writing: " << outputFilename << endl;
+        return EXIT_FAILURE;
+    }
+    cout << polygons.size() << " polygons written to " << outputFilename << endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,153 @@
+//
+//  generateScene.cpp
+//  ComputerGraphics
+//
+//  Created by agent on 10/17/26.
+//  Copyright © 2026 agent. All rights reserved.
+//
+//  writes a random scene (see SceneGenerator.hpp) as a text scene file or a binary scene file (see SceneFile.hpp)
+//  the polygons are written as they are created so scenes of millions of polygons do not need to fit in memory
+//  built as the generateScene target of CMakeLists.txt
+//  usage: generateScene output [--binary] [--no-bounding-boxes] [--polygons N] [--vertices MIN MAX]
+//                       [--radius R] [--overdraw X] [--sizes fixed|uniform|exponential]
+//                       [--order random|front-to-back|back-to-front] [--layers N] [--rotation DEGREES]
+//                       [--off-screen FRACTION] [--size WIDTH HEIGHT] [--depth NEAR FAR] [--seed S]
+//  (the defaults are the defaults of SceneGenerator::Options; --overdraw sets the radius from the window area)
+//
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "ConvexPolygon.hpp"
+#include "SceneFile.hpp"
+#include "SceneGenerator.hpp"
+
+using namespace std;
+
+int main(int argc, char **argv) {
+    if (argc < 2 || string(argv[1]).compare(0, 2, "--") == 0) {
+        cerr << "usage: " << argv[0] << " output [--binary] [--no-bounding-boxes] [--polygons N] [--vertices MIN MAX]" << endl;
+        cerr << "       [--radius R] [--overdraw X] [--sizes fixed|uniform|exponential]" << endl;
+        cerr << "       [--order random|front-to-back|back-to-front] [--layers N] [--rotation DEGREES]" << endl;
+        cerr << "       [--off-screen FRACTION] [--size WIDTH HEIGHT] [--depth NEAR FAR] [--seed S]" << endl;
+        return EXIT_FAILURE;
+    }
+    string outputFilename = argv[1];
+    bool binary = false;
+    bool boundingBoxes = true;
+    SceneGenerator::Options options;
+
+    for (int i=2; i<argc; ++i) {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        bool hasTwoValues = i + 2 < argc;
+        if (arg == "--binary") {
+            binary = true;
+        }
+        else if (arg == "--no-bounding-boxes") {
+            boundingBoxes = false;
+        }
+        else if (arg == "--polygons" && hasValue) {
+            options.numPolygons = strtoull(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--vertices" && hasTwoValues) {
+            options.minVertices = atoi(argv[++i]);
+            options.maxVertices = atoi(argv[++i]);
+        }
+        else if (arg == "--radius" && hasValue) {
+            options.radius = float(atof(argv[++i]));
+        }
+        else if (arg == "--overdraw" && hasValue) {
+            options.overdraw = float(atof(argv[++i]));
+        }
+        else if (arg == "--sizes" && hasValue) {
+            string value = argv[++i];
+            if (value == "fixed") {
+                options.sizeDistribution = SceneGenerator::Fixed;
+            }
+            else if (value == "uniform") {
+                options.sizeDistribution = SceneGenerator::Uniform;
+            }
+            else if (value == "exponential") {
+                options.sizeDistribution = SceneGenerator::Exponential;
+            }
+            else {
+                cerr << "unknown size distribution: " << value << endl;
+                return EXIT_FAILURE;
+            }
+        }
+        else if (arg == "--order" && hasValue) {
+            string value = argv[++i];
+            if (value == "random") {
+                options.depthOrder = SceneGenerator::RandomDepth;
+            }
+            else if (value == "front-to-back") {
+                options.depthOrder = SceneGenerator::FrontToBack;
+            }
+            else if (value == "back-to-front") {
+                options.depthOrder = SceneGenerator::BackToFront;
+            }
+            else {
+                cerr << "unknown depth order: " << value << endl;
+                return EXIT_FAILURE;
+            }
+        }
+        else if (arg == "--layers" && hasValue) {
+            options.depthLayers = atoi(argv[++i]);
+        }
+        else if (arg == "--rotation" && hasValue) {
+            options.maxRotation = float(atof(argv[++i]));
+        }
+        else if (arg == "--off-screen" && hasValue) {
+            options.offScreenFraction = float(atof(argv[++i]));
+        }
+        else if (arg == "--size" && hasTwoValues) {
+            options.width = atoi(argv[++i]);
+            options.height = atoi(argv[++i]);
+        }
+        else if (arg == "--depth" && hasTwoValues) {
+            options.nearZ = float(atof(argv[++i]));
+            options.farZ = float(atof(argv[++i]));
+        }
+        else if (arg == "--seed" && hasValue) {
+            options.seed = uint32_t(strtoul(argv[++i], nullptr, 10));
+        }
+        else {
+            cerr << "unknown or incomplete option: " << arg << endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    SceneGenerator generator(options);
+    ConvexPolygon polygon;
+    bool written;
+    if (binary) {
+        // each section of the file is a pass over the polygons, so they are created again for each one
+        written = SceneFile::write(outputFilename, options.numPolygons, [&](size_t i) -> const ConvexPolygon& {
+            if (i == 0) {
+                generator.restart();
+            }
+            generator.next(polygon);
+            return polygon;
+        }, boundingBoxes);
+    }
+    else {
+        ofstream outfile(outputFilename.c_str());
+        // enough digits that reading the file gives exactly the same floats as the binary file
+        outfile.precision(9);
+        for (size_t i=0; i<options.numPolygons && outfile; ++i) {
+            generator.next(polygon);
+            outfile << polygon;
+        }
+        written = bool(outfile);
+    }
+
+    if (!written) {
+        cerr << "error writing: " << outputFilename << endl;
+        return EXIT_FAILURE;
+    }
+    cout << options.numPolygons << " polygons with radius " << generator.radius() << " written to " << outputFilename << endl;
+    return EXIT_SUCCESS;
+}